@@ -0,0 +1,318 @@
+// Microbenchmarks of the Worker queue & parking, against the `std::queue` + `std::condition_variable` they replaced.
+// Usage: ConcurrentBenchmark [itemCount] [maxThreads]
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/concurrent/Executor.hxx"
+#include "core/concurrent/Lock.hxx"
+#include "core/concurrent/LockFreeQueue.hxx"
+
+using namespace DynXX::Core::Concurrent;
+
+namespace
+{
+    constexpr auto QueueCapacity = 1024uz;
+
+    template<typename F>
+    double secondsOf(F &&f)
+    {
+        const auto begin = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    }
+
+    void report(const char *name, const size_t threads, const size_t ops, const double seconds)
+    {
+        std::printf("%-36s %2zu threads %10.2f Mops/s %10.1f ns/op\n", name, threads, ops / seconds / 1e6, seconds * 1e9 / ops);
+    }
+
+    /// The former Worker queue
+    class MutexQueue final
+    {
+    public:
+        void push(size_t v)
+        {
+            {
+                auto lock = std::scoped_lock(this->mutex);
+                this->queue.push(v);
+            }
+            this->cv.notify_one();
+        }
+
+        bool tryPop(size_t &v)
+        {
+            auto lock = std::scoped_lock(this->mutex);
+            if (this->queue.empty())
+            {
+                return false;
+            }
+            v = this->queue.front();
+            this->queue.pop();
+            return true;
+        }
+
+        size_t pop()
+        {
+            auto lock = std::unique_lock(this->mutex);
+            this->cv.wait(lock, [this] { return !this->queue.empty(); });
+            const auto v = this->queue.front();
+            this->queue.pop();
+            return v;
+        }
+
+    private:
+        std::queue<size_t> queue;
+        std::mutex mutex;
+        std::condition_variable cv;
+    };
+
+    /// The current Worker queue: a bounded lock-free queue, the consumer parks while it is empty
+    class ParkingQueue final
+    {
+    public:
+        void push(size_t v)
+        {
+            while (!this->queue.tryPush(std::move(v)))
+            {
+                std::this_thread::yield();
+            }
+            this->parker.unpark();
+        }
+
+        size_t pop()
+        {
+            size_t v;
+            while (!this->queue.tryPop(v))
+            {
+                this->parker.park();
+            }
+            return v;
+        }
+
+    private:
+        BoundedMPMCQueue<size_t> queue{QueueCapacity};
+        Parker parker;
+    };
+
+    /// Many producers to one consumer, the pattern of submitting to a Worker
+    template<typename Q>
+    void benchHandoff(const char *name, const size_t producers, const size_t itemCount)
+    {
+        Q q;
+        const auto perProducer = itemCount / producers;
+        const auto seconds = secondsOf([&] {
+            std::vector<std::thread> threads;
+            for (auto p = 0uz; p < producers; p++)
+            {
+                threads.emplace_back([&q, perProducer] {
+                    for (auto i = 0uz; i < perProducer; i++)
+                    {
+                        q.push(i);
+                    }
+                });
+            }
+            auto sum = 0uz;
+            for (auto i = 0uz; i < perProducer * producers; i++)
+            {
+                sum += q.pop();
+            }
+            for (auto &t : threads)
+            {
+                t.join();
+            }
+            if (sum != producers * (perProducer * (perProducer - 1) / 2)) [[unlikely]]
+            {
+                std::fprintf(stderr, "%s: lost items\n", name);
+                std::exit(EXIT_FAILURE);
+            }
+        });
+        report(name, producers + 1, perProducer * producers, seconds);
+    }
+
+    /// Producers & consumers spinning on a non-blocking queue, the raw cost of enqueue + dequeue under contention
+    template<typename PushF, typename PopF>
+    void benchContention(const char *name, const size_t pairs, const size_t itemCount, PushF &&push, PopF &&pop)
+    {
+        const auto perProducer = itemCount / pairs;
+        std::atomic<size_t> consumed{0};
+        const auto total = perProducer * pairs;
+        const auto seconds = secondsOf([&] {
+            std::vector<std::thread> threads;
+            for (auto p = 0uz; p < pairs; p++)
+            {
+                threads.emplace_back([&push, perProducer] {
+                    for (auto i = 0uz; i < perProducer; i++)
+                    {
+                        while (!push(i))
+                        {
+                            std::this_thread::yield();
+                        }
+                    }
+                });
+                threads.emplace_back([&pop, &consumed, total] {
+                    size_t v;
+                    while (consumed.load(std::memory_order_relaxed) < total)
+                    {
+                        if (pop(v))
+                        {
+                            consumed.fetch_add(1, std::memory_order_relaxed);
+                        }
+                        else
+                        {
+                            std::this_thread::yield();
+                        }
+                    }
+                });
+            }
+            for (auto &t : threads)
+            {
+                t.join();
+            }
+        });
+        report(name, pairs * 2, total, seconds);
+    }
+
+    /// Two threads waking each other in turn, the latency of a wakeup
+    template<typename Waiter>
+    void benchPingPong(const char *name, const size_t rounds)
+    {
+        Waiter ping;
+        Waiter pong;
+        const auto seconds = secondsOf([&] {
+            std::thread t([&] {
+                for (auto i = 0uz; i < rounds; i++)
+                {
+                    ping.wait();
+                    pong.notify();
+                }
+            });
+            for (auto i = 0uz; i < rounds; i++)
+            {
+                ping.notify();
+                pong.wait();
+            }
+            t.join();
+        });
+        report(name, 2, rounds, seconds);
+    }
+
+    class CVWaiter final
+    {
+    public:
+        void wait()
+        {
+            auto lock = std::unique_lock(this->mutex);
+            this->cv.wait(lock, [this] { return this->notified; });
+            this->notified = false;
+        }
+
+        void notify()
+        {
+            {
+                auto lock = std::scoped_lock(this->mutex);
+                this->notified = true;
+            }
+            this->cv.notify_one();
+        }
+
+    private:
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool notified{false};
+    };
+
+    class ParkerWaiter final
+    {
+    public:
+        void wait()
+        {
+            while (!this->notified.exchange(false, std::memory_order_acquire))
+            {
+                this->parker.park();
+            }
+        }
+
+        void notify()
+        {
+            this->notified.store(true, std::memory_order_release);
+            this->parker.unpark();
+        }
+
+    private:
+        std::atomic<bool> notified{false};
+        Parker parker;
+    };
+
+    /// Submitting tiny tasks to an Executor and waiting for all of them
+    void benchExecutor(const size_t workers, const size_t taskCount)
+    {
+        std::atomic<size_t> done{0};
+        Parker parker;
+        // Destroyed first, so the last task never touches `parker` after it is gone
+        Executor executor(ExecutorConfig{.minWorkerCount = workers, .maxWorkerCount = workers, .workStealing = true});
+        const auto seconds = secondsOf([&] {
+            for (auto i = 0uz; i < taskCount; i++)
+            {
+                executor >> [&done, &parker, taskCount] {
+                    if (done.fetch_add(1, std::memory_order_acq_rel) + 1 == taskCount)
+                    {
+                        parker.unpark();
+                    }
+                };
+            }
+            while (done.load(std::memory_order_acquire) < taskCount)
+            {
+                parker.park();
+            }
+        });
+        report("Executor submit & run", workers + 1, taskCount, seconds);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const auto itemCount = argc > 1 ? std::stoul(argv[1]) : 1'000'000uz;
+    const auto cpuCores = std::thread::hardware_concurrency();
+    const auto maxThreads = argc > 2 ? std::stoul(argv[2]) : std::max(cpuCores, 2u);
+    std::printf("CPU cores: %u, max threads: %zu, items: %zu\n\n", cpuCores, static_cast<size_t>(maxThreads), static_cast<size_t>(itemCount));
+
+    std::printf("Handoff, producers -> 1 consumer, parking while empty:\n");
+    for (auto producers = 1uz; producers < maxThreads; producers *= 2)
+    {
+        benchHandoff<MutexQueue>("std::queue + mutex + cv", producers, itemCount);
+        benchHandoff<ParkingQueue>("BoundedMPMCQueue + Parker", producers, itemCount);
+    }
+
+    std::printf("\nContention, producers & consumers spinning:\n");
+    for (auto pairs = 1uz; pairs * 2 <= maxThreads; pairs *= 2)
+    {
+        MutexQueue mq;
+        benchContention("std::queue + mutex", pairs, itemCount,
+                        [&mq](size_t v) { mq.push(v); return true; },
+                        [&mq](size_t &v) { return mq.tryPop(v); });
+        BoundedMPMCQueue<size_t> lq{QueueCapacity};
+        benchContention("BoundedMPMCQueue", pairs, itemCount,
+                        [&lq](size_t v) { return lq.tryPush(std::move(v)); },
+                        [&lq](size_t &v) { return lq.tryPop(v); });
+    }
+
+    std::printf("\nPing-pong wakeups:\n");
+    const auto rounds = std::max(itemCount / 10uz, 1uz);
+    benchPingPong<CVWaiter>("mutex + cv", rounds);
+    benchPingPong<ParkerWaiter>("Parker", rounds);
+
+    std::printf("\nExecutor:\n");
+    for (auto workers = 1uz; workers < maxThreads; workers *= 2)
+    {
+        benchExecutor(workers, itemCount);
+    }
+    return EXIT_SUCCESS;
+}
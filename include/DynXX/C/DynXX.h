@@ -45,6 +45,13 @@ const char *dynxx_root_path();
  */
 void dynxx_release(void);
 
+/**
+ * @brief Read the stats of the shared task executor, for pool sizing and finding long-running tasks
+ * @warning Not accessible in JS/Lua!
+ * @return JSON of counters & latency histograms (in micro seconds) of the executor and each worker
+ */
+const char *dynxx_executor_stats(void);
+
 EXTERN_C_END
 
 #endif // DYNXX_INCLUDE_H_
@@ -5,6 +5,17 @@
 
 EXTERN_C_BEGIN
 
+/**
+ * JS call error
+ */
+enum DynXXJsCallError {
+    DynXXJsCallErrorNone = 0, // Successful
+    DynXXJsCallErrorNotReady = 1, // JS is not initialized
+    DynXXJsCallErrorNotFound = 2, // No such JS func
+    DynXXJsCallErrorException = 3, // JS func threw or the promise was rejected
+    DynXXJsCallErrorTimeout = 4, // JS func was interrupted, or the promise was not settled, within the budget
+};
+
 /**
  * @brief Load JS file
  * @warning Not accessible in JS/Lua!
@@ -44,12 +55,69 @@ bool dynxx_js_loadB(const byte *bytes, size_t len, bool is_module);
  */
 const char *dynxx_js_call(const char *func, const char *params, bool await);
 
+/**
+ * @brief Call JS function within a time budget, a runaway script is interrupted when the budget runs out
+ * @warning Not accessible in JS/Lua!
+ * @param func JS function name
+ * @param params JS function params（wrap multiple params with json）
+ * @param await Whether wait for the promise result or not
+ * @param budget_ms Time budget in milliseconds including awaiting, `0` for no limit
+ * @param err Output of the error, see `DynXXJsCallError`, can be `NULL`
+ * @return return value of JS function, empty if failed
+ */
+const char *dynxx_js_call_budget(const char *func, const char *params, bool await, size_t budget_ms, int *err);
+
+/**
+ * @brief Look up a global JS function, and pin it in all JS VMs for `dynxx_js_call_handle`
+ * @warning Not accessible in JS/Lua! Reassigning the global later does not change the pinned function.
+ * @param func JS function name
+ * @return Handle of the function, `0` if not found
+ */
+size_t dynxx_js_lookup(const char *func);
+
+/**
+ * @brief Call JS function by the handle from `dynxx_js_lookup`, without looking it up by name
+ * @warning Not accessible in JS/Lua!
+ * @param handle JS function handle
+ * @param params JS function params（wrap multiple params with json）
+ * @param await Whether wait for the promise result or not
+ * @return return value of JS function
+ */
+const char *dynxx_js_call_handle(size_t handle, const char *params, bool await);
+
 /**
  * @brief Set JS msg callback
  * @param callback JS msg callback
  */
 void dynxx_js_set_msg_callback(const char *(*const callback)(const char *msg));
 
+/**
+ * @brief Set the pool of JS VMs, each one is an isolated runtime loaded with the same scripts
+ * @warning Not accessible in JS/Lua! Do not call it while JS funcs are running.
+ * @param size VM count, `0` to use the count of CPU cores, `1` by default
+ * @param routing How `dynxx_js_call` is dispatched to VMs, see `DynXXVMRouting`
+ * @return success or not
+ */
+bool dynxx_js_set_pool(size_t size, int routing);
+
+/**
+ * @brief Set the limits & GC of JS VMs, applied to the existing VMs and the ones created later
+ * @warning Not accessible in JS/Lua!
+ * @param memory_limit Heap limit in bytes, `0` for no limit
+ * @param gc_threshold Allocated bytes triggering a GC, `0` for the QuickJS default
+ * @param max_stack_size Max stack size in bytes of a JS call, `0` for the QuickJS default
+ * @param idle_gc_interval_ms Interval of GC while a VM is idle, `0` to disable it
+ * @return success or not
+ */
+bool dynxx_js_set_vm_config(size_t memory_limit, size_t gc_threshold, size_t max_stack_size, size_t idle_gc_interval_ms);
+
+/**
+ * @brief Get the memory usage of JS VMs
+ * @warning Not accessible in JS/Lua!
+ * @return JSON array of the QuickJS memory breakdown, one item per VM of the pool
+ */
+const char *dynxx_js_memory_usage();
+
 EXTERN_C_END
 
 #endif // DYNXX_INCLUDE_JS_H_
@@ -22,6 +22,15 @@ bool dynxx_lua_loadF(const char *file);
  */
 bool dynxx_lua_loadS(const char *script);
 
+/**
+ * @brief Load precompiled Lua chunk (e.g. output of `luac`)
+ * @warning Not accessible in JS/Lua!
+ * @param bytes Byte array data
+ * @param len Byte array length
+ * @return success or not
+ */
+bool dynxx_lua_loadB(const byte *bytes, size_t len);
+
 /**
  * @brief Call Lua function
  * @warning Not accessible in JS/Lua!
@@ -31,6 +40,48 @@ bool dynxx_lua_loadS(const char *script);
  */
 const char *dynxx_lua_call(const char *func, const char *params);
 
+/**
+ * @brief Look up a global Lua function, and pin it by a registry ref in all Lua states for `dynxx_lua_call_ref`
+ * @warning Not accessible in JS/Lua! Reassigning the global later does not change the pinned function.
+ * @param func Lua function name
+ * @return Ref of the function, `0` if not found
+ */
+size_t dynxx_lua_lookup(const char *func);
+
+/**
+ * @brief Call Lua function by the ref from `dynxx_lua_lookup`, without looking it up by name
+ * @warning Not accessible in JS/Lua!
+ * @param ref Lua function ref
+ * @param params Lua function params（wrap multiple params with json）, not necessarily NUL-terminated
+ * @param params_len Length of `params`
+ * @return return value of Lua function
+ */
+const char *dynxx_lua_call_ref(size_t ref, const char *params, size_t params_len);
+
+/**
+ * @brief Set the pool of Lua states, each one is an isolated `lua_State` loaded with the same scripts
+ * @warning Not accessible in JS/Lua! Do not call it while Lua funcs are running.
+ * @param size State count, `0` to use the count of CPU cores, `1` by default
+ * @param routing How `dynxx_lua_call` is dispatched to states, see `DynXXVMRouting`
+ * @return success or not
+ */
+bool dynxx_lua_set_pool(size_t size, int routing);
+
+/**
+ * @brief Set the hard memory limit of each Lua state, applied to the existing states and the ones created later
+ * @warning Not accessible in JS/Lua! Allocations beyond the limit raise a Lua memory error after an emergency GC.
+ * @param limit Limit in bytes, counting small objects by their 64KB arena chunks, `0` for no limit
+ * @return success or not
+ */
+bool dynxx_lua_set_memory_limit(size_t limit);
+
+/**
+ * @brief Get the memory stats of Lua states
+ * @warning Not accessible in JS/Lua!
+ * @return JSON array of the allocator counters, one item per state of the pool
+ */
+const char *dynxx_lua_memory_stats();
+
 EXTERN_C_END
 
 #endif // DYNXX_INCLUDE_LUA_H_
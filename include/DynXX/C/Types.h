@@ -11,6 +11,14 @@ EXTERN_C_BEGIN
 typedef unsigned char byte;
 typedef intptr_t address;
 
+/**
+ * @brief How calls are dispatched to a pool of script VMs
+ */
+enum DynXXVMRouting {
+    DynXXVMRoutingAnyFree, ///< Any free VM, for stateless scripts
+    DynXXVMRoutingSticky ///< The same VM for the same caller thread, keeping script states between calls
+};
+
 EXTERN_C_END
 
 #endif // DYNXX_INCLUDE_TYPES_H_
@@ -21,4 +21,6 @@ std::string dynxxRootPath();
 
 void dynxxRelease();
 
+std::string dynxxExecutorStats();
+
 #endif // DYNXX_INCLUDE_HXX_
@@ -3,16 +3,81 @@
 
 #include "Types.hxx"
 
+#include <expected>
 #include <functional>
 
+enum class DynXXJsCallErrorX : int {
+    None = 0,
+    NotReady = 1,
+    NotFound = 2,
+    Exception = 3,
+    Timeout = 4,
+};
+
+/// Settings of each JS VM, applied on creation, see `dynxxJsSetVMConfig`
+struct DynXXJsVMConfig {
+    /// Heap limit in bytes, `0` for no limit
+    size_t memoryLimit{0};
+    /// Allocated bytes triggering a GC, `0` for the QuickJS default
+    size_t gcThreshold{0};
+    /// Max stack size in bytes of a JS call, `0` for the QuickJS default
+    size_t maxStackSize{0};
+    /// Interval of GC while the VM is idle, `0` to disable it
+    size_t idleGcIntervalMilliSecs{0};
+};
+
+/// Memory usage of a JS VM, as computed by QuickJS
+struct DynXXJsMemoryUsage {
+    int64_t mallocSize{0};
+    int64_t mallocLimit{0};
+    int64_t memoryUsedSize{0};
+    int64_t mallocCount{0};
+    int64_t memoryUsedCount{0};
+    int64_t atomCount{0};
+    int64_t atomSize{0};
+    int64_t strCount{0};
+    int64_t strSize{0};
+    int64_t objCount{0};
+    int64_t objSize{0};
+    int64_t propCount{0};
+    int64_t propSize{0};
+    int64_t shapeCount{0};
+    int64_t shapeSize{0};
+    int64_t jsFuncCount{0};
+    int64_t jsFuncSize{0};
+    int64_t jsFuncCodeSize{0};
+    int64_t jsFuncPc2lineCount{0};
+    int64_t jsFuncPc2lineSize{0};
+    int64_t cFuncCount{0};
+    int64_t arrayCount{0};
+    int64_t fastArrayCount{0};
+    int64_t fastArrayElements{0};
+    int64_t binaryObjectCount{0};
+    int64_t binaryObjectSize{0};
+
+    [[nodiscard]] std::optional<std::string> toJson() const;
+};
+
 bool dynxxJsLoadF(const std::string &file, bool isModule);
 
 bool dynxxJsLoadS(const std::string &script, const std::string &name, bool isModule);
 
 bool dynxxJsLoadB(const Bytes &bytes, bool isModule);
 
-std::optional<std::string> dynxxJsCall(std::string_view func, std::string_view params, bool await);
+std::expected<std::string, DynXXJsCallErrorX> dynxxJsCall(std::string_view func, std::string_view params, bool await,
+                                                          size_t budgetMilliSecs = 0);
+
+size_t dynxxJsLookup(std::string_view func);
+
+std::expected<std::string, DynXXJsCallErrorX> dynxxJsCallHandle(size_t handle, std::string_view params, bool await,
+                                                                size_t budgetMilliSecs = 0);
 
 void dynxxJsSetMsgCallback(const std::function<const char *(const char *msg)> &callback);
 
+bool dynxxJsSetPool(size_t size, DynXXVMRoutingX routing = DynXXVMRoutingX::AnyFree);
+
+bool dynxxJsSetVMConfig(const DynXXJsVMConfig &config);
+
+std::vector<DynXXJsMemoryUsage> dynxxJsMemoryUsage();
+
 #endif // DYNXX_INCLUDE_JS_H_
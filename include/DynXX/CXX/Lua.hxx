@@ -3,10 +3,40 @@
 
 #include "Types.hxx"
 
+/// Memory stats of a Lua state, counted by its allocator
+struct DynXXLuaMemoryStats {
+    /// Bytes used by the state
+    int64_t usedSize{0};
+    /// Peak of `usedSize`
+    int64_t peakSize{0};
+    /// Hard limit of the memory taken by the state, i.e. the large blocks plus `arenaSize`, `0` for no limit
+    int64_t limitSize{0};
+    /// Bytes of the small object slabs, included in the process memory & the limit, but not in `usedSize`
+    int64_t arenaSize{0};
+    /// Count of allocations
+    int64_t allocCount{0};
+    /// Count of allocations failed, mostly by the limit
+    int64_t failedCount{0};
+
+    [[nodiscard]] std::optional<std::string> toJson() const;
+};
+
 bool dynxxLuaLoadF(const std::string &f);
 
 bool dynxxLuaLoadS(const std::string &s);
 
+bool dynxxLuaLoadB(const Bytes &bytes);
+
 std::optional<std::string> dynxxLuaCall(std::string_view f, std::string_view ps);
 
+size_t dynxxLuaLookup(std::string_view f);
+
+std::optional<std::string> dynxxLuaCallRef(size_t ref, std::string_view ps);
+
+bool dynxxLuaSetPool(size_t size, DynXXVMRoutingX routing = DynXXVMRoutingX::AnyFree);
+
+bool dynxxLuaSetMemoryLimit(size_t limit);
+
+std::vector<DynXXLuaMemoryStats> dynxxLuaMemoryStats();
+
 #endif // DYNXX_INCLUDE_LUA_HXX_
@@ -22,6 +22,11 @@
 #include <limits>
 #include <type_traits>
 
+enum class DynXXVMRoutingX : int {
+    AnyFree,
+    Sticky
+};
+
 // Concepts
 
 template<typename T>
@@ -21,7 +21,7 @@ void *dynxxZZipInit(const DynXXZipCompressModeX mode = DynXXZipCompressModeX::De
                      size_t bufferSize = DynXXZDefaultBufferSize,
                      const DynXXZFormatX format = DynXXZFormatX::ZLib);
 
-size_t dynxxZZipInput(void *const zip, const Bytes &inBytes, bool inFinish);
+size_t dynxxZZipInput(void *const zip, BytesView inBytes, bool inFinish);
 
 Bytes dynxxZZipProcessDo(void *const zip);
 
@@ -32,7 +32,7 @@ void dynxxZZipRelease(void *const zip);
 void *dynxxZUnzipInit(size_t bufferSize = DynXXZDefaultBufferSize,
                        const DynXXZFormatX format = DynXXZFormatX::ZLib);
 
-size_t dynxxZUnzipInput(void *const unzip, const Bytes &inBytes, bool inFinish);
+size_t dynxxZUnzipInput(void *const unzip, BytesView inBytes, bool inFinish);
 
 Bytes dynxxZUnzipProcessDo(void *const unzip);
 
@@ -58,12 +58,12 @@ bool dynxxZCxxStreamUnzip(std::istream *cxxStreamIn, std::ostream *cxxStreamOut,
                            size_t bufferSize = DynXXZDefaultBufferSize,
                            const DynXXZFormatX format = DynXXZFormatX::ZLib);
 
-Bytes dynxxZBytesZip(const Bytes &inBytes,
+Bytes dynxxZBytesZip(BytesView inBytes,
                       const DynXXZipCompressModeX mode = DynXXZipCompressModeX::Default,
                       size_t bufferSize = DynXXZDefaultBufferSize,
                       const DynXXZFormatX format = DynXXZFormatX::ZLib);
 
-Bytes dynxxZBytesUnzip(const Bytes &inBytes,
+Bytes dynxxZBytesUnzip(BytesView inBytes,
                         size_t bufferSize = DynXXZDefaultBufferSize,
                         const DynXXZFormatX format = DynXXZFormatX::ZLib);
 
@@ -126,10 +126,7 @@ function DynXXNetHttpDownload(url, file, timeout) {
 }
 
 function DynXXStoreSQLiteOpen(_id) {
-    let inJson = JSON.stringify({
-        "_id": _id
-    });
-    return dynxx_store_sqlite_open(inJson);
+    return dynxx_store_sqlite_openT(_id);
 }
 
 function DynXXStoreSQLiteExecute(conn, sql) {
@@ -149,144 +146,75 @@ function DynXXStoreSQLiteQueryDo(conn, sql) {
 }
 
 function DynXXStoreSQLiteQueryReadRow(query_result) {
-    let inJson = JSON.stringify({
-        "query_result": query_result
-    });
-    return dynxx_store_sqlite_query_read_row(inJson);
+    return dynxx_store_sqlite_query_read_rowT(query_result);
 }
 
 function DynXXStoreSQLiteQueryReadColumnText(query_result, column) {
-    let inJson = JSON.stringify({
-        "query_result": query_result,
-        "column": column
-    });
-    return dynxx_store_sqlite_query_read_column_text(inJson);
+    return dynxx_store_sqlite_query_read_column_textT(query_result, column) ?? '';
 }
 
 function DynXXStoreSQLiteQueryReadColumnInteger(query_result, column) {
-    let inJson = JSON.stringify({
-        "query_result": query_result,
-        "column": column
-    });
-    return dynxx_store_sqlite_query_read_column_integer(inJson);
+    return dynxx_store_sqlite_query_read_column_integerT(query_result, column) ?? 0;
 }
 
 function DynXXStoreSQLiteQueryReadColumnFloat(query_result, column) {
-    let inJson = JSON.stringify({
-        "query_result": query_result,
-        "column": column
-    });
-    return dynxx_store_sqlite_query_read_column_float(inJson);
+    return dynxx_store_sqlite_query_read_column_floatT(query_result, column) ?? 0;
 }
 
 function DynXXStoreSQLiteQueryDrop(query_result) {
-    let inJson = JSON.stringify({
-        "query_result": query_result
-    });
-    dynxx_store_sqlite_query_drop(inJson);
+    dynxx_store_sqlite_query_dropT(query_result);
 }
 
 function DynXXStoreSQLiteClose(conn) {
-    let inJson = JSON.stringify({
-        "conn": conn
-    });
-    dynxx_store_sqlite_close(inJson);
+    dynxx_store_sqlite_closeT(conn);
 }
 
 function DynXXStoreKVOpen(_id) {
-    let inJson = JSON.stringify({
-        "_id": _id
-    });
-    return dynxx_store_kv_open(inJson);
+    return dynxx_store_kv_openT(_id);
 }
 
 function DynXXStoreKVReadString(conn, k) {
-    let inJson = JSON.stringify({
-        "conn": conn,
-        "k": k
-    });
-    return dynxx_store_kv_read_string(inJson);
+    return dynxx_store_kv_read_stringT(conn, k) ?? '';
 }
 
 function DynXXStoreKVWriteString(conn, k, s) {
-    let inJson = JSON.stringify({
-        "conn": conn,
-        "k": k,
-        "v": s
-    });
-    return dynxx_store_kv_write_string(inJson);
+    return dynxx_store_kv_write_stringT(conn, k, s ?? '');
 }
 
 function DynXXStoreKVReadInteger(conn, k) {
-    let inJson = JSON.stringify({
-        "conn": conn,
-        "k": k
-    });
-    return dynxx_store_kv_read_integer(inJson);
+    return dynxx_store_kv_read_integerT(conn, k) ?? 0;
 }
 
 function DynXXStoreKVWriteInteger(conn, k, i) {
-    let inJson = JSON.stringify({
-        "conn": conn,
-        "k": k,
-        "v": i
-    });
-    return dynxx_store_kv_write_integer(inJson);
+    return dynxx_store_kv_write_integerT(conn, k, i ?? 0);
 }
 
 function DynXXStoreKVReadFloat(conn, k) {
-    let inJson = JSON.stringify({
-        "conn": conn,
-        "k": k
-    });
-    return dynxx_store_kv_read_float(inJson);
+    return dynxx_store_kv_read_floatT(conn, k) ?? 0;
 }
 
 function DynXXStoreKVWriteFloat(conn, k, f) {
-    let inJson = JSON.stringify({
-        "conn": conn,
-        "k": k,
-        "v": f
-    });
-    return dynxx_store_kv_write_float(inJson);
+    return dynxx_store_kv_write_floatT(conn, k, f ?? 0);
 }
 
 function DynXXStoreKVAllKeys(conn) {
-    let inJson = JSON.stringify({
-        "conn": conn
-    });
-    let outJson = dynxx_store_kv_all_keys(inJson);
-    return _json2Array(outJson);
+    return dynxx_store_kv_all_keysT(conn);
 }
 
 function DynXXStoreKVContains(conn, k) {
-    let inJson = JSON.stringify({
-        "conn": conn,
-        "k": k
-    });
-    return dynxx_store_kv_contains(inJson);
+    return dynxx_store_kv_containsT(conn, k);
 }
 
 function DynXXStoreKVRemove(conn, k) {
-    let inJson = JSON.stringify({
-        "conn": conn,
-        "k": k
-    });
-    dynxx_store_kv_remove(inJson);
+    dynxx_store_kv_removeT(conn, k);
 }
 
 function DynXXStoreKVClear(conn) {
-    let inJson = JSON.stringify({
-        "conn": conn
-    });
-    dynxx_store_kv_clear(inJson);
+    dynxx_store_kv_clearT(conn);
 }
 
 function DynXXStoreKVClose(conn) {
-    let inJson = JSON.stringify({
-        "conn": conn
-    });
-    dynxx_store_kv_close(inJson);
+    dynxx_store_kv_closeT(conn);
 }
 
 function DynXXStr2Bytes(str) {
@@ -334,19 +262,11 @@ function DynXXCodingStr2Bytes(str) {
 }
 
 function DynXXCodingCaseUpper(str) {
-    str = str || '';
-    let inJson = JSON.stringify({
-        "str": str
-    });
-    return dynxx_coding_case_upper(inJson);
+    return dynxx_coding_case_upperT(str || '');
 }
 
 function DynXXCodingCaseLower(str) {
-    str = str || '';
-    let inJson = JSON.stringify({
-        "str": str
-    });
-    return dynxx_coding_case_lower(inJson);
+    return dynxx_coding_case_lowerT(str || '');
 }
 
 function DynXXCryptoRand(len) {
@@ -485,6 +405,56 @@ function DynXXCryptoBase64Decode(inBytes, noNewLines) {
     return _json2Array(outJson);
 }
 
+/// Crypto with bytes as `ArrayBuffer`/`Uint8Array`, much faster than number arrays for large data
+
+function DynXXCryptoRandB(len) {
+    return new Uint8Array(dynxx_crypto_randB(len));
+}
+
+function DynXXCryptoAesEncryptB(inBuffer, keyBuffer) {
+    return new Uint8Array(dynxx_crypto_aes_encryptB(inBuffer, keyBuffer));
+}
+
+function DynXXCryptoAesDecryptB(inBuffer, keyBuffer) {
+    return new Uint8Array(dynxx_crypto_aes_decryptB(inBuffer, keyBuffer));
+}
+
+function DynXXCryptoAesGcmEncryptB(inBuffer, keyBuffer, ivBuffer, tagBits, aadBuffer) {
+    return new Uint8Array(dynxx_crypto_aes_gcm_encryptB(inBuffer, keyBuffer, ivBuffer, tagBits, aadBuffer));
+}
+
+function DynXXCryptoAesGcmDecryptB(inBuffer, keyBuffer, ivBuffer, tagBits, aadBuffer) {
+    return new Uint8Array(dynxx_crypto_aes_gcm_decryptB(inBuffer, keyBuffer, ivBuffer, tagBits, aadBuffer));
+}
+
+function DynXXCryptoRsaEncryptB(inBuffer, keyBuffer, padding) {
+    return new Uint8Array(dynxx_crypto_rsa_encryptB(inBuffer, keyBuffer, padding));
+}
+
+function DynXXCryptoRsaDecryptB(inBuffer, keyBuffer, padding) {
+    return new Uint8Array(dynxx_crypto_rsa_decryptB(inBuffer, keyBuffer, padding));
+}
+
+function DynXXCryptoHashMD5B(inBuffer) {
+    return new Uint8Array(dynxx_crypto_hash_md5B(inBuffer));
+}
+
+function DynXXCryptoHashSHA1B(inBuffer) {
+    return new Uint8Array(dynxx_crypto_hash_sha1B(inBuffer));
+}
+
+function DynXXCryptoHashSHA256B(inBuffer) {
+    return new Uint8Array(dynxx_crypto_hash_sha256B(inBuffer));
+}
+
+function DynXXCryptoBase64EncodeB(inBuffer, noNewLines) {
+    return new Uint8Array(dynxx_crypto_base64_encodeB(inBuffer, (noNewLines === undefined || noNewLines) ? 1 : 0));
+}
+
+function DynXXCryptoBase64DecodeB(inBuffer, noNewLines) {
+    return new Uint8Array(dynxx_crypto_base64_decodeB(inBuffer, (noNewLines === undefined || noNewLines) ? 1 : 0));
+}
+
 //let DynXXZBufferSize = 16 * 1024
 
 function _DynXXZZipInit(mode, bufferSize, format) {
@@ -588,6 +558,14 @@ function DynXXZUnZipBytes(bytes, bufferSize, format) {
     return dynxx_z_bytes_unzip(inJson);
 }
 
+function DynXXZZipBytesB(buffer, mode, bufferSize, format) {
+    return dynxx_z_bytes_zipB(buffer, mode, bufferSize, format).then((out) => new Uint8Array(out));
+}
+
+function DynXXZUnZipBytesB(buffer, bufferSize, format) {
+    return dynxx_z_bytes_unzipB(buffer, bufferSize, format).then((out) => new Uint8Array(out));
+}
+
 function _DynXXZStream(bufferSize, readFunc, writeFunc, flushFunc,
     z, inputFunc, processDoFunc, processFinishedFunc) {
     var inputFinished = false;
@@ -653,55 +631,58 @@ function DynXXZUnZipStream(readFunc, writeFunc, flushFunc, bufferSize, format) {
     return res;
 }
 
-function DynXXZZipFile(inFilePath, outFilePath, mode, bufferSize, format) {
+/// Files are read & written with `Uint8Array`s, which are passed to native without copying
+function _DynXXZFile(inFilePath, outFilePath, bufferSize, z, inputFunc, processDoFunc, processFinishedFunc) {
     let inF = std.open(inFilePath, 'r');
     let outF = std.open(outFilePath, 'w');
+    let inBuffer = new Uint8Array(bufferSize);
 
-    let res = DynXXZZipStream(
+    let res = _DynXXZStream(bufferSize,
         () => {
-            let inBuffer = new ArrayBuffer(bufferSize);
-            inF.read(inBuffer, 0, bufferSize);
-            return _buffer2Bytes(inBuffer);
+            let len = inF.read(inBuffer.buffer, 0, bufferSize);
+            return inBuffer.subarray(0, len);
         },
         (bytes) => {
-            let outBuffer = _bytes2Buffer(bytes);
-            outF.write(outBuffer, 0, bytes.length);
+            outF.write(bytes.buffer, bytes.byteOffset, bytes.length);
         },
         () => {
             outF.flush();
         },
-        mode, 
-        bufferSize, 
-        format
-    );
+        z, inputFunc, processDoFunc, processFinishedFunc);
 
     outF.close();
     inF.close();
     return res;
 }
 
+function DynXXZZipFile(inFilePath, outFilePath, mode, bufferSize, format) {
+    let zip = _DynXXZZipInit(mode, bufferSize, format);
+
+    let res = _DynXXZFile(inFilePath, outFilePath, bufferSize, zip,
+        (z, buffer, inputFinished) => {
+            return dynxx_z_zip_inputB(z, buffer, inputFinished ? 1 : 0);
+        }, (z) => {
+            return new Uint8Array(dynxx_z_zip_process_doB(z));
+        }, (z) => {
+            return _DynXXZZipProcessFinished(z);
+        });
+
+    _DynXXZZipRelease(zip);
+    return res;
+}
+
 function DynXXZUnZipFile(inFilePath, outFilePath, bufferSize, format) {
-    let inF = std.open(inFilePath, 'r');
-    let outF = std.open(outFilePath, 'w');
+    let unzip = _DynXXZUnZipInit(bufferSize, format);
 
-    let res = DynXXZUnZipStream(
-        () => {
-            let inBuffer = new ArrayBuffer(bufferSize);
-            inF.read(inBuffer, 0, bufferSize);
-            return _buffer2Bytes(inBuffer);
-        },
-        (bytes) => {
-            let outBuffer = _bytes2Buffer(bytes);
-            outF.write(outBuffer, 0, bytes.length);
-        },
-        () => {
-            outF.flush();
-        },
-        bufferSize, 
-        format
-    );
+    let res = _DynXXZFile(inFilePath, outFilePath, bufferSize, unzip,
+        (z, buffer, inputFinished) => {
+            return dynxx_z_unzip_inputB(z, buffer, inputFinished ? 1 : 0);
+        }, (z) => {
+            return new Uint8Array(dynxx_z_unzip_process_doB(z));
+        }, (z) => {
+            return _DynXXZUnZipProcessFinished(z);
+        });
 
-    outF.close();
-    inF.close();
+    _DynXXZUnZipRelease(unzip);
     return res;
 }
@@ -191,6 +191,42 @@ declare function DynXXCryptoBase64Encode(inBytes: number[], noNewLines?: boolean
 
 declare function DynXXCryptoBase64Decode(inBytes: number[], noNewLines?: boolean): number[]
 
+declare function DynXXCryptoRandB(len: number): Uint8Array
+
+declare function DynXXCryptoAesEncryptB(inBuffer: ArrayBuffer | Uint8Array, keyBuffer: ArrayBuffer | Uint8Array): Uint8Array
+
+declare function DynXXCryptoAesDecryptB(inBuffer: ArrayBuffer | Uint8Array, keyBuffer: ArrayBuffer | Uint8Array): Uint8Array
+
+declare function DynXXCryptoAesGcmEncryptB(
+    inBuffer: ArrayBuffer | Uint8Array,
+    keyBuffer: ArrayBuffer | Uint8Array,
+    ivBuffer: ArrayBuffer | Uint8Array,
+    tagBits: number,
+    aadBuffer?: ArrayBuffer | Uint8Array
+): Uint8Array
+
+declare function DynXXCryptoAesGcmDecryptB(
+    inBuffer: ArrayBuffer | Uint8Array,
+    keyBuffer: ArrayBuffer | Uint8Array,
+    ivBuffer: ArrayBuffer | Uint8Array,
+    tagBits: number,
+    aadBuffer?: ArrayBuffer | Uint8Array
+): Uint8Array
+
+declare function DynXXCryptoRsaEncryptB(inBuffer: ArrayBuffer | Uint8Array, keyBuffer: ArrayBuffer | Uint8Array, padding?: number): Uint8Array
+
+declare function DynXXCryptoRsaDecryptB(inBuffer: ArrayBuffer | Uint8Array, keyBuffer: ArrayBuffer | Uint8Array, padding?: number): Uint8Array
+
+declare function DynXXCryptoHashMD5B(inBuffer: ArrayBuffer | Uint8Array): Uint8Array
+
+declare function DynXXCryptoHashSHA1B(inBuffer: ArrayBuffer | Uint8Array): Uint8Array
+
+declare function DynXXCryptoHashSHA256B(inBuffer: ArrayBuffer | Uint8Array): Uint8Array
+
+declare function DynXXCryptoBase64EncodeB(inBuffer: ArrayBuffer | Uint8Array, noNewLines?: boolean): Uint8Array
+
+declare function DynXXCryptoBase64DecodeB(inBuffer: ArrayBuffer | Uint8Array, noNewLines?: boolean): Uint8Array
+
 /// Zip
 
 const enum DynXXZFormat {
@@ -220,6 +256,19 @@ declare function DynXXZUnZipBytes(
     format?: DynXXZFormat
 ): Promise<number[]>
 
+declare function DynXXZZipBytesB(
+    buffer: ArrayBuffer | Uint8Array,
+    mode?: DynXXZZipMode,
+    bufferSize?: number,
+    format?: DynXXZFormat
+): Promise<Uint8Array>
+
+declare function DynXXZUnZipBytesB(
+    buffer: ArrayBuffer | Uint8Array,
+    bufferSize?: number,
+    format?: DynXXZFormat
+): Promise<Uint8Array>
+
 declare function DynXXZZipStream(
     readFunc: () => number[],
     writeFunc: (bytes: number[]) => void,
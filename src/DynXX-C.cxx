@@ -38,6 +38,12 @@ void dynxx_release() {
     dynxxRelease();
 }
 
+EXPORT
+const char *dynxx_executor_stats() {
+    const auto s = dynxxExecutorStats();
+    return dupStr(s);
+}
+
 // Device.DeviceInfo
 
 EXPORT_AUTO
@@ -535,7 +541,7 @@ void *dynxx_z_zip_init(int mode, size_t bufferSize, int format) {
 
 EXPORT_AUTO
 size_t dynxx_z_zip_input(void *const zip, const byte *inBytes, size_t inLen, bool inFinish) {
-    return dynxxZZipInput(zip, makeBytes(inBytes, inLen), inFinish);
+    return dynxxZZipInput(zip, makeBytesView(inBytes, inLen), inFinish);
 }
 
 EXPORT_AUTO
@@ -561,7 +567,7 @@ void *dynxx_z_unzip_init(size_t bufferSize, int format) {
 
 EXPORT_AUTO
 size_t dynxx_z_unzip_input(void *const unzip, const byte *inBytes, size_t inLen, bool inFinish) {
-    return dynxxZUnzipInput(unzip, makeBytes(inBytes, inLen), inFinish);
+    return dynxxZUnzipInput(unzip, makeBytesView(inBytes, inLen), inFinish);
 }
 
 EXPORT_AUTO
@@ -613,7 +619,7 @@ bool dynxx_z_cxxstream_unzip(size_t bufferSize, int format, void *const cxxStrea
 EXPORT_AUTO
 const byte *dynxx_z_bytes_zip(int mode, size_t bufferSize, int format, const byte *inBytes, size_t inLen,
                                size_t *outLen) {
-    const auto bytes = dynxxZBytesZip(makeBytes(inBytes, inLen),
+    const auto bytes = dynxxZBytesZip(makeBytesView(inBytes, inLen),
                                         static_cast<DynXXZipCompressModeX>(mode), bufferSize,
                                         static_cast<DynXXZFormatX>(format));
     return handleBytes(bytes, outLen);
@@ -621,7 +627,7 @@ const byte *dynxx_z_bytes_zip(int mode, size_t bufferSize, int format, const byt
 
 EXPORT_AUTO
 const byte *dynxx_z_bytes_unzip(size_t bufferSize, int format, const byte *inBytes, size_t inLen, size_t *outLen) {
-    const auto bytes = dynxxZBytesUnzip(makeBytes(inBytes, inLen),
+    const auto bytes = dynxxZBytesUnzip(makeBytesView(inBytes, inLen),
                                           bufferSize, static_cast<DynXXZFormatX>(format));
     return handleBytes(bytes, outLen);
 }
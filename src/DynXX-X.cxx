@@ -9,6 +9,7 @@
 #include "core/crypto/Crypto.hxx"
 #include "core/device/Device.hxx"
 #include "core/log/Log.hxx"
+#include "core/concurrent/Executor.hxx"
 
 #if defined(USE_CURL)
 #include "core/net/HttpClient.hxx"
@@ -61,6 +62,34 @@ namespace {
     std::unique_ptr<const std::string> _root = nullptr;
 #endif
 
+    cJSON *histogramToJson(const Concurrent::LatencyHistogram::Snapshot &histogram) {
+        const auto cj = cJSON_CreateObject();
+        cJSON_AddNumberToObject(cj, "count", static_cast<double>(histogram.count));
+        cJSON_AddNumberToObject(cj, "mean", histogram.mean());
+        cJSON_AddNumberToObject(cj, "p50", static_cast<double>(histogram.valueAt(50)));
+        cJSON_AddNumberToObject(cj, "p90", static_cast<double>(histogram.valueAt(90)));
+        cJSON_AddNumberToObject(cj, "p99", static_cast<double>(histogram.valueAt(99)));
+        cJSON_AddNumberToObject(cj, "p999", static_cast<double>(histogram.valueAt(99.9)));
+        cJSON_AddNumberToObject(cj, "max", static_cast<double>(histogram.max));
+        return cj;
+    }
+
+    cJSON *workerStatsToJson(const Concurrent::WorkerStats &stats) {
+        const auto cj = cJSON_CreateObject();
+        cJSON_AddBoolToObject(cj, "idle", stats.idle);
+        const auto cjPending = cJSON_CreateObject();
+        cJSON_AddNumberToObject(cjPending, "high", static_cast<double>(stats.pendingCount[static_cast<size_t>(Concurrent::TaskPriority::High)]));
+        cJSON_AddNumberToObject(cjPending, "normal", static_cast<double>(stats.pendingCount[static_cast<size_t>(Concurrent::TaskPriority::Normal)]));
+        cJSON_AddNumberToObject(cjPending, "low", static_cast<double>(stats.pendingCount[static_cast<size_t>(Concurrent::TaskPriority::Low)]));
+        cJSON_AddItemToObject(cj, "pendingCount", cjPending);
+        cJSON_AddNumberToObject(cj, "executedCount", static_cast<double>(stats.executedCount));
+        cJSON_AddNumberToObject(cj, "stolenCount", static_cast<double>(stats.stolenCount));
+        cJSON_AddNumberToObject(cj, "expiredCount", static_cast<double>(stats.expiredCount));
+        cJSON_AddItemToObject(cj, "waitTimeMicroSecs", histogramToJson(stats.waitTime));
+        cJSON_AddItemToObject(cj, "runTimeMicroSecs", histogramToJson(stats.runTime));
+        return cj;
+    }
+
 #if defined(USE_STD_CHAR_CONV_INT)
     template <NumberT T>
     T fromChars(const std::string &str, const T defaultV)
@@ -245,6 +274,28 @@ void dynxxRelease() {
 #endif
 }
 
+std::string dynxxExecutorStats() {
+    const auto stats = Concurrent::Executor::shared().stats();
+
+    const auto cj = cJSON_CreateObject();
+    cJSON_AddNumberToObject(cj, "workerCount", static_cast<double>(stats.workerCount));
+    cJSON_AddNumberToObject(cj, "minWorkerCount", static_cast<double>(stats.minWorkerCount));
+    cJSON_AddNumberToObject(cj, "maxWorkerCount", static_cast<double>(stats.maxWorkerCount));
+    cJSON_AddNumberToObject(cj, "createdWorkerCount", static_cast<double>(stats.createdWorkerCount));
+    cJSON_AddNumberToObject(cj, "retiredWorkerCount", static_cast<double>(stats.retiredWorkerCount));
+    cJSON_AddNumberToObject(cj, "submittedCount", static_cast<double>(stats.submittedCount));
+    cJSON_AddItemToObject(cj, "total", workerStatsToJson(stats.total));
+    const auto cjWorkers = cJSON_CreateArray();
+    for (const auto &worker : stats.workers) {
+        cJSON_AddItemToArray(cjWorkers, workerStatsToJson(worker));
+    }
+    cJSON_AddItemToObject(cj, "workers", cjWorkers);
+
+    const auto json = Json::cJSONToStr(cj);
+    cJSON_Delete(cj);
+    return json.value_or("");
+}
+
 // Device.Device
 
 DynXXDeviceTypeX dynxxDeviceType() {
@@ -455,6 +506,76 @@ std::optional<std::string> DynXXHttpResponse::toJson() const {
     return json;
 }
 
+#if defined(USE_LUA)
+std::optional<std::string> DynXXLuaMemoryStats::toJson() const {
+    const std::pair<const char *, int64_t> items[] = {
+        {"usedSize", this->usedSize},
+        {"peakSize", this->peakSize},
+        {"limitSize", this->limitSize},
+        {"arenaSize", this->arenaSize},
+        {"allocCount", this->allocCount},
+        {"failedCount", this->failedCount},
+    };
+
+    const auto cj = cJSON_CreateObject();
+    for (const auto &[k, v]: items) {
+        if (!cJSON_AddNumberToObject(cj, k, static_cast<double>(v))) [[unlikely]] {
+            cJSON_Delete(cj);
+            return std::nullopt;
+        }
+    }
+
+    auto json = dynxxJsonToStr(cj);
+    cJSON_Delete(cj);
+    return json;
+}
+#endif
+
+#if defined(USE_QJS)
+std::optional<std::string> DynXXJsMemoryUsage::toJson() const {
+    const std::pair<const char *, int64_t> items[] = {
+        {"mallocSize", this->mallocSize},
+        {"mallocLimit", this->mallocLimit},
+        {"memoryUsedSize", this->memoryUsedSize},
+        {"mallocCount", this->mallocCount},
+        {"memoryUsedCount", this->memoryUsedCount},
+        {"atomCount", this->atomCount},
+        {"atomSize", this->atomSize},
+        {"strCount", this->strCount},
+        {"strSize", this->strSize},
+        {"objCount", this->objCount},
+        {"objSize", this->objSize},
+        {"propCount", this->propCount},
+        {"propSize", this->propSize},
+        {"shapeCount", this->shapeCount},
+        {"shapeSize", this->shapeSize},
+        {"jsFuncCount", this->jsFuncCount},
+        {"jsFuncSize", this->jsFuncSize},
+        {"jsFuncCodeSize", this->jsFuncCodeSize},
+        {"jsFuncPc2lineCount", this->jsFuncPc2lineCount},
+        {"jsFuncPc2lineSize", this->jsFuncPc2lineSize},
+        {"cFuncCount", this->cFuncCount},
+        {"arrayCount", this->arrayCount},
+        {"fastArrayCount", this->fastArrayCount},
+        {"fastArrayElements", this->fastArrayElements},
+        {"binaryObjectCount", this->binaryObjectCount},
+        {"binaryObjectSize", this->binaryObjectSize},
+    };
+
+    const auto cj = cJSON_CreateObject();
+    for (const auto &[k, v]: items) {
+        if (!cJSON_AddNumberToObject(cj, k, static_cast<double>(v))) [[unlikely]] {
+            cJSON_Delete(cj);
+            return std::nullopt;
+        }
+    }
+
+    auto json = dynxxJsonToStr(cj);
+    cJSON_Delete(cj);
+    return json;
+}
+#endif
+
 DynXXHttpResponse dynxxNetHttpRequest(std::string_view url,
                                         DynXXHttpMethodX method,
                                         const DictAny &params,
@@ -804,7 +925,7 @@ void *dynxxZZipInit(const DynXXZipCompressModeX mode, size_t bufferSize, const D
     return zip;
 }
 
-size_t dynxxZZipInput(void *const zip, const Bytes &inBytes, bool inFinish) {
+size_t dynxxZZipInput(void *const zip, BytesView inBytes, bool inFinish) {
     if (zip == nullptr) {
         return 0;
     }
@@ -848,7 +969,7 @@ void *dynxxZUnzipInit(size_t bufferSize, const DynXXZFormatX format) {
     return unzip;
 }
 
-size_t dynxxZUnzipInput(void *const unzip, const Bytes &inBytes, bool inFinish) {
+size_t dynxxZUnzipInput(void *const unzip, BytesView inBytes, bool inFinish) {
     if (unzip == nullptr) {
         return 0;
     }
@@ -928,7 +1049,7 @@ bool dynxxZCxxStreamUnzip(std::istream *cxxStreamIn, std::ostream *cxxStreamOut,
 
 #endif
 
-Bytes dynxxZBytesZip(const Bytes &inBytes, const DynXXZipCompressModeX mode, size_t bufferSize,
+Bytes dynxxZBytesZip(BytesView inBytes, const DynXXZipCompressModeX mode, size_t bufferSize,
                       const DynXXZFormatX format) {
     if (bufferSize == 0) {
         return {};
@@ -939,7 +1060,7 @@ Bytes dynxxZBytesZip(const Bytes &inBytes, const DynXXZipCompressModeX mode, siz
     return Z::zip(static_cast<int>(mode), bufferSize, static_cast<int>(format), inBytes);
 }
 
-Bytes dynxxZBytesUnzip(const Bytes &inBytes, size_t bufferSize, const DynXXZFormatX format) {
+Bytes dynxxZBytesUnzip(BytesView inBytes, size_t bufferSize, const DynXXZFormatX format) {
     if (bufferSize == 0) {
         return {};
     }
@@ -4,49 +4,190 @@
 #include <cstring>
 #include <cstdlib>
 
+#include <algorithm>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <functional>
 
 #include <DynXX/CXX/Macro.hxx>
+#include <DynXX/CXX/DynXX.hxx>
 
 #include "../core/vm/JSVM.hxx"
+#include "../core/vm/JSBinding.hxx"
+#include "../core/vm/VMPool.hxx"
 #include "ScriptAPI.hxx"
 
 namespace {
-    std::unique_ptr<DynXX::Core::VM::JSVM> vm = nullptr;
+    using DynXX::Core::VM::JSVM;
+
+    std::unique_ptr<DynXX::Core::VM::VMPool<JSVM>> vmPool = nullptr;
     std::function<const char *(const char *msg)> msgCbk = nullptr;
+    DynXXJsVMConfig vmConfig;
+    std::mutex vmConfigMutex;
+    std::unordered_map<std::string, JSVM::FuncHandle, TransparentStringHash, std::equal_to<>> funcHandles;
+    JSVM::FuncHandle nextFuncHandle = 1;
+    std::mutex funcHandlesMutex;
 
 #define DEF_API(f, T) DEF_JS_FUNC_##T(f##J, f##S)
-#define DEF_API_ASYNC(f, T) DEF_JS_FUNC_##T##_ASYNC(vm, f##J, f##S)
-
-#define BIND_API(f) vm->bindFunc(#f, f##J)
+#define DEF_API_ASYNC(f, T) DEF_JS_FUNC_##T##_ASYNC(f##J, f##S, DynXX::Core::Concurrent::TaskPriority::Normal)
+/// For bulk work (large transfers, (un)zip), which should not delay latency-sensitive calls.
+#define DEF_API_ASYNC_BULK(f, T) DEF_JS_FUNC_##T##_ASYNC(f##J, f##S, DynXX::Core::Concurrent::TaskPriority::Low)
+
+#define BIND_API(f) JS_CFUNC_DEF(#f, 1, f##J)
+
+/// Bytes are passed as `ArrayBuffer`/typed arrays in & `ArrayBuffer` out, without any JSON or copy
+#define ARG_BYTES(i) argBytes(ctx, argc, argv, i)
+#define ARG_INT(i, defaultI) argInt64(ctx, argc, argv, i, defaultI)
+#define ARG_PTR(i) argPtr(ctx, argc, argv, i)
+#define DEF_API_BYTES(f, expr)                                                 \
+  static JSValue f##B(JS_FUNC_PARAMS) {                                        \
+    return JSVM::newArrayBuffer(ctx, expr);                                    \
+  }
+#define BIND_API_BYTES(f, argc) JS_CFUNC_DEF(#f "B", argc, f##B)
+
+/// Arguments are mapped to the parameters of the C++ API `fX` directly, without any JSON
+#define DEF_API_TYPED(f, fX) DEF_JS_FUNC_TYPED(f##T, fX)
+#define BIND_API_TYPED(f, fX) BIND_JS_FUNC_TYPED(#f "T", f##T, fX)
 
     bool loadF(const std::string &file, const bool isModule) {
-        if (!vm || file.empty()) [[unlikely]] {
+        if (!vmPool || file.empty()) [[unlikely]] {
             return false;
         }
-        return vm->loadFile(file, isModule);
+        return vmPool->load([file, isModule](JSVM &vm) {
+            return vm.loadFile(file, isModule);
+        });
     }
 
     bool loadS(const std::string &script, const std::string &name, const bool isModule) {
-        if (!vm || script.empty() || name.empty()) [[unlikely]] {
+        if (!vmPool || script.empty() || name.empty()) [[unlikely]] {
             return false;
         }
-        return vm->loadScript(script, name, isModule);
+        return vmPool->load([script, name, isModule](JSVM &vm) {
+            return vm.loadScript(script, name, isModule);
+        });
     }
 
     bool loadB(const Bytes &bytes, const bool isModule) {
-        if (!vm || bytes.empty()) [[unlikely]] {
+        if (!vmPool || bytes.empty()) [[unlikely]] {
+            return false;
+        }
+        return vmPool->load([bytes, isModule](JSVM &vm) {
+            return vm.loadBinary(bytes, isModule);
+        });
+    }
+
+    std::expected<std::string, DynXXJsCallErrorX> call(std::string_view func, std::string_view params, const bool await,
+                                                       const size_t budgetMilliSecs) {
+        if (!vmPool) [[unlikely]] {
+            return std::unexpected(DynXXJsCallErrorX::NotReady);
+        }
+        if (func.empty()) [[unlikely]] {
+            return std::unexpected(DynXXJsCallErrorX::NotFound);
+        }
+        return vmPool->with([func, params, await, budgetMilliSecs](JSVM &vm) {
+            return vm.callFunc(func, params, await, budgetMilliSecs);
+        });
+    }
+
+    /// Handles are shared by all VMs of the pool, failed ones are never reused
+    JSVM::FuncHandle lookup(std::string_view func) {
+        if (!vmPool || func.empty()) [[unlikely]] {
+            return 0;
+        }
+        auto lock = std::scoped_lock(funcHandlesMutex);
+        if (const auto it = funcHandles.find(func); it != funcHandles.end()) {
+            return it->second;
+        }
+        const auto handle = nextFuncHandle++;
+        auto pinned = true;
+        vmPool->forEach([handle, func, &pinned](JSVM &vm) {
+            pinned = vm.pinFunc(handle, func) && pinned;
+        });
+        if (!pinned) [[unlikely]] {
+            return 0;
+        }
+        // Pin in the VMs created later, it does nothing in the existing ones
+        vmPool->load([handle, name = std::string(func)](JSVM &vm) {
+            return vm.pinFunc(handle, name);
+        });
+        funcHandles.emplace(func, handle);
+        return handle;
+    }
+
+    std::expected<std::string, DynXXJsCallErrorX> callHandle(const JSVM::FuncHandle handle, std::string_view params,
+                                                             const bool await, const size_t budgetMilliSecs) {
+        if (!vmPool) [[unlikely]] {
+            return std::unexpected(DynXXJsCallErrorX::NotReady);
+        }
+        if (handle == 0) [[unlikely]] {
+            return std::unexpected(DynXXJsCallErrorX::NotFound);
+        }
+        return vmPool->with([handle, params, await, budgetMilliSecs](JSVM &vm) {
+            return vm.callFunc(handle, params, await, budgetMilliSecs);
+        });
+    }
+
+    bool setPool(const size_t size, const DynXXVMRoutingX routing) {
+        if (!vmPool) [[unlikely]] {
+            return false;
+        }
+        return vmPool->resize(size, routing);
+    }
+
+    /// Applied to the existing VMs, and to the ones created by resizing later
+    bool setVMConfig(const DynXXJsVMConfig &config) {
+        if (!vmPool) [[unlikely]] {
             return false;
         }
-        return vm->loadBinary(bytes, isModule);
+        {
+            auto lock = std::scoped_lock(vmConfigMutex);
+            vmConfig = config;
+        }
+        vmPool->forEach([&config](JSVM &vm) {
+            vm.configure(config);
+        });
+        return true;
     }
 
-    std::optional<std::string> call(std::string_view func, std::string_view params, const bool await) {
-        if (!vm || func.empty()) [[unlikely]] {
-            return std::nullopt;
+    std::vector<DynXXJsMemoryUsage> memoryUsage() {
+        std::vector<DynXXJsMemoryUsage> usages;
+        if (!vmPool) [[unlikely]] {
+            return usages;
         }
-        return vm->callFunc(func, params, await);
+        vmPool->forEach([&usages](JSVM &vm) {
+            usages.emplace_back(vm.memoryUsage());
+        });
+        return usages;
+    }
+
+    BytesView argBytes(JSContext *ctx, const int argc, JSValueConst *argv, const int i) {
+        return i < argc ? JSVM::toBytesView(ctx, argv[i]) : BytesView{};
+    }
+
+    /// Objects are not converted: their `valueOf()` could run JS, changing the buffers already viewed by `ARG_BYTES`
+    int64_t argInt64(JSContext *ctx, const int argc, JSValueConst *argv, const int i, const int64_t defaultI) {
+        int64_t v = defaultI;
+        if (i < argc && !JS_IsUndefined(argv[i]) && !JS_IsObject(argv[i]) && JS_ToInt64(ctx, &v, argv[i]) < 0) [[unlikely]] {
+            JS_FreeValue(ctx, JS_GetException(ctx));
+            return defaultI;
+        }
+        return v;
+    }
+
+    /// Handles of zip/unzip, the address strings returned by `*_init`; objects are rejected as in `argInt64`
+    void *argPtr(JSContext *ctx, const int argc, JSValueConst *argv, const int i) {
+        if (i >= argc || JS_IsObject(argv[i])) [[unlikely]] {
+            return nullptr;
+        }
+        const auto s = JS_ToCString(ctx, argv[i]);
+        if (s == nullptr) [[unlikely]] {
+            JS_FreeValue(ctx, JS_GetException(ctx));
+            return nullptr;
+        }
+        const auto addr = str2int64(s, 0);
+        JS_FreeCString(ctx, s);
+        return addr2ptr(addr);
     }
 
     void setMsgCallback(const std::function<const char *(const char *msg)> &callback) {
@@ -79,14 +220,36 @@ bool dynxxJsLoadB(const Bytes &bytes, bool isModule) {
     return loadB(bytes, isModule);
 }
 
-std::optional<std::string> dynxxJsCall(const std::string &func, const std::string &params, bool await) {
-    return call(func, params, await);
+std::expected<std::string, DynXXJsCallErrorX> dynxxJsCall(std::string_view func, std::string_view params, bool await,
+                                                          size_t budgetMilliSecs) {
+    return call(func, params, await, budgetMilliSecs);
+}
+
+size_t dynxxJsLookup(std::string_view func) {
+    return lookup(func);
+}
+
+std::expected<std::string, DynXXJsCallErrorX> dynxxJsCallHandle(size_t handle, std::string_view params, bool await,
+                                                                size_t budgetMilliSecs) {
+    return callHandle(handle, params, await, budgetMilliSecs);
 }
 
 void dynxxJsSetMsgCallback(const std::function<const char *(const char *msg)> &callback) {
     setMsgCallback(callback);
 }
 
+bool dynxxJsSetPool(size_t size, DynXXVMRoutingX routing) {
+    return setPool(size, routing);
+}
+
+bool dynxxJsSetVMConfig(const DynXXJsVMConfig &config) {
+    return setVMConfig(config);
+}
+
+std::vector<DynXXJsMemoryUsage> dynxxJsMemoryUsage() {
+    return memoryUsage();
+}
+
 // C API
 
 EXPORT_AUTO
@@ -113,11 +276,70 @@ const char *dynxx_js_call(const char *func, const char *params, bool await) {
     return dupStr(s);
 }
 
+EXPORT_AUTO
+const char *dynxx_js_call_budget(const char *func, const char *params, bool await, size_t budget_ms, int *err) {
+    if (func == nullptr) [[unlikely]] {
+        if (err != nullptr) {
+            *err = static_cast<int>(DynXXJsCallErrorX::NotFound);
+        }
+        return "";
+    }
+    const auto res = dynxxJsCall(func, params ? params : "", await, budget_ms);
+    if (err != nullptr) {
+        *err = static_cast<int>(res.has_value() ? DynXXJsCallErrorX::None : res.error());
+    }
+    return dupStr(res.value_or(""));
+}
+
+EXPORT_AUTO
+size_t dynxx_js_lookup(const char *func) {
+    if (func == nullptr) [[unlikely]] {
+        return 0;
+    }
+    return dynxxJsLookup(func);
+}
+
+EXPORT_AUTO
+const char *dynxx_js_call_handle(size_t handle, const char *params, bool await) {
+    const auto s = dynxxJsCallHandle(handle, params ? params : "", await).value_or("");
+    return dupStr(s);
+}
+
 EXPORT_AUTO
 void dynxx_js_set_msg_callback(const char *(*const callback)(const char *msg)) {
     dynxxJsSetMsgCallback(callback);
 }
 
+EXPORT_AUTO
+bool dynxx_js_set_pool(size_t size, int routing) {
+    return dynxxJsSetPool(size, static_cast<DynXXVMRoutingX>(routing));
+}
+
+EXPORT_AUTO
+bool dynxx_js_set_vm_config(size_t memory_limit, size_t gc_threshold, size_t max_stack_size, size_t idle_gc_interval_ms) {
+    return dynxxJsSetVMConfig({
+        .memoryLimit = memory_limit,
+        .gcThreshold = gc_threshold,
+        .maxStackSize = max_stack_size,
+        .idleGcIntervalMilliSecs = idle_gc_interval_ms
+    });
+}
+
+EXPORT_AUTO
+const char *dynxx_js_memory_usage() {
+    std::string s = "[";
+    for (const auto &usage : dynxxJsMemoryUsage()) {
+        if (const auto json = usage.toJson(); json.has_value()) [[likely]] {
+            if (s.size() > 1) {
+                s += ",";
+            }
+            s += json.value();
+        }
+    }
+    s += "]";
+    return dupStr(s);
+}
+
 // JS API - Declaration
 
 DEF_API(dynxx_call_platform, STRING)
@@ -134,7 +356,7 @@ DEF_API(dynxx_device_cpu_arch, INT32)
 DEF_API(dynxx_log_print, VOID)
 
 DEF_API_ASYNC(dynxx_net_http_request, STRING)
-DEF_API_ASYNC(dynxx_net_http_download, BOOL)
+DEF_API_ASYNC_BULK(dynxx_net_http_download, BOOL)
 
 DEF_API(dynxx_store_sqlite_open, STRING)
 DEF_API_ASYNC(dynxx_store_sqlite_execute, BOOL)
@@ -190,103 +412,238 @@ DEF_API(dynxx_z_unzip_input, INT64)
 DEF_API(dynxx_z_unzip_process_do, STRING)
 DEF_API(dynxx_z_unzip_process_finished, BOOL)
 DEF_API(dynxx_z_unzip_release, VOID)
-DEF_API_ASYNC(dynxx_z_bytes_zip, STRING)
-DEF_API_ASYNC(dynxx_z_bytes_unzip, STRING)
+DEF_API_ASYNC_BULK(dynxx_z_bytes_zip, STRING)
+DEF_API_ASYNC_BULK(dynxx_z_bytes_unzip, STRING)
+
+// JS API - Bytes
+
+DEF_API_BYTES(dynxx_crypto_rand, dynxxCryptoRand(static_cast<size_t>(std::max<int64_t>(ARG_INT(0, 0), 0))))
+DEF_API_BYTES(dynxx_crypto_aes_encrypt, dynxxCryptoAesEncrypt(ARG_BYTES(0), ARG_BYTES(1)))
+DEF_API_BYTES(dynxx_crypto_aes_decrypt, dynxxCryptoAesDecrypt(ARG_BYTES(0), ARG_BYTES(1)))
+DEF_API_BYTES(dynxx_crypto_aes_gcm_encrypt, dynxxCryptoAesGcmEncrypt(ARG_BYTES(0), ARG_BYTES(1), ARG_BYTES(2), static_cast<size_t>(ARG_INT(3, 0)), ARG_BYTES(4)))
+DEF_API_BYTES(dynxx_crypto_aes_gcm_decrypt, dynxxCryptoAesGcmDecrypt(ARG_BYTES(0), ARG_BYTES(1), ARG_BYTES(2), static_cast<size_t>(ARG_INT(3, 0)), ARG_BYTES(4)))
+DEF_API_BYTES(dynxx_crypto_rsa_encrypt, dynxxCryptoRsaEncrypt(ARG_BYTES(0), ARG_BYTES(1), static_cast<DynXXCryptoRSAPaddingX>(ARG_INT(2, static_cast<int64_t>(DynXXCryptoRSAPaddingX::PKCS1)))))
+DEF_API_BYTES(dynxx_crypto_rsa_decrypt, dynxxCryptoRsaDecrypt(ARG_BYTES(0), ARG_BYTES(1), static_cast<DynXXCryptoRSAPaddingX>(ARG_INT(2, static_cast<int64_t>(DynXXCryptoRSAPaddingX::PKCS1)))))
+DEF_API_BYTES(dynxx_crypto_hash_md5, dynxxCryptoHashMd5(ARG_BYTES(0)))
+DEF_API_BYTES(dynxx_crypto_hash_sha1, dynxxCryptoHashSha1(ARG_BYTES(0)))
+DEF_API_BYTES(dynxx_crypto_hash_sha256, dynxxCryptoHashSha256(ARG_BYTES(0)))
+DEF_API_BYTES(dynxx_crypto_base64_encode, dynxxCryptoBase64Encode(ARG_BYTES(0), ARG_INT(1, 1) != 0))
+DEF_API_BYTES(dynxx_crypto_base64_decode, dynxxCryptoBase64Decode(ARG_BYTES(0), ARG_INT(1, 1) != 0))
+
+DEF_API_BYTES(dynxx_z_zip_process_do, dynxxZZipProcessDo(ARG_PTR(0)))
+DEF_API_BYTES(dynxx_z_unzip_process_do, dynxxZUnzipProcessDo(ARG_PTR(0)))
+
+static JSValue dynxx_z_zip_inputB(JS_FUNC_PARAMS) {
+    return JS_NewInt64(ctx, static_cast<int64_t>(dynxxZZipInput(ARG_PTR(0), ARG_BYTES(1), ARG_INT(2, 0) != 0)));
+}
 
-// JS API - Binding
+static JSValue dynxx_z_unzip_inputB(JS_FUNC_PARAMS) {
+    return JS_NewInt64(ctx, static_cast<int64_t>(dynxxZUnzipInput(ARG_PTR(0), ARG_BYTES(1), ARG_INT(2, 0) != 0)));
+}
+
+/// Input is copied once, since the JS buffer may be changed or released while zipping in background
+static JSValue dynxx_z_bytes_zipB(JS_FUNC_PARAMS) {
+    const auto vm = JSVM::fromContext(ctx);
+    DEF_JS_FUNC_CHECK_VM(vm);
+    const auto in = ARG_BYTES(0);
+    return vm->newPromiseBytes([inBytes = Bytes(in.begin(), in.end()),
+                                mode = static_cast<DynXXZipCompressModeX>(ARG_INT(1, static_cast<int64_t>(DynXXZipCompressModeX::Default))),
+                                bufferSize = static_cast<size_t>(ARG_INT(2, DynXXZDefaultBufferSize)),
+                                format = static_cast<DynXXZFormatX>(ARG_INT(3, static_cast<int64_t>(DynXXZFormatX::ZLib)))] {
+        return dynxxZBytesZip(inBytes, mode, bufferSize, format);
+    }, DynXX::Core::Concurrent::TaskPriority::Low);
+}
 
-static void registerFuncs() {
-    if (!vm) [[unlikely]] return;
-    BIND_API(dynxx_call_platform);
-
-    BIND_API(dynxx_get_version);
-    BIND_API(dynxx_root_path);
-
-    BIND_API(dynxx_log_print);
-
-    BIND_API(dynxx_device_type);
-    BIND_API(dynxx_device_name);
-    BIND_API(dynxx_device_manufacturer);
-    BIND_API(dynxx_device_os_version);
-    BIND_API(dynxx_device_cpu_arch);
-
-    BIND_API(dynxx_net_http_request);
-    BIND_API(dynxx_net_http_download);
-
-    BIND_API(dynxx_store_sqlite_open);
-    BIND_API(dynxx_store_sqlite_execute);
-    BIND_API(dynxx_store_sqlite_query_do);
-    BIND_API(dynxx_store_sqlite_query_read_row);
-    BIND_API(dynxx_store_sqlite_query_read_column_text);
-    BIND_API(dynxx_store_sqlite_query_read_column_integer);
-    BIND_API(dynxx_store_sqlite_query_read_column_float);
-    BIND_API(dynxx_store_sqlite_query_drop);
-    BIND_API(dynxx_store_sqlite_close);
-
-    BIND_API(dynxx_store_kv_open);
-    BIND_API(dynxx_store_kv_read_string);
-    BIND_API(dynxx_store_kv_write_string);
-    BIND_API(dynxx_store_kv_read_integer);
-    BIND_API(dynxx_store_kv_write_integer);
-    BIND_API(dynxx_store_kv_read_float);
-    BIND_API(dynxx_store_kv_write_float);
-    BIND_API(dynxx_store_kv_all_keys);
-    BIND_API(dynxx_store_kv_contains);
-    BIND_API(dynxx_store_kv_remove);
-    BIND_API(dynxx_store_kv_clear);
-    BIND_API(dynxx_store_kv_close);
-
-    BIND_API(dynxx_coding_hex_bytes2str);
-    BIND_API(dynxx_coding_hex_str2bytes);
-    BIND_API(dynxx_coding_bytes2str);
-    BIND_API(dynxx_coding_str2bytes);
-    BIND_API(dynxx_coding_case_upper);
-    BIND_API(dynxx_coding_case_lower);
-
-    BIND_API(dynxx_crypto_rand);
-    BIND_API(dynxx_crypto_aes_encrypt);
-    BIND_API(dynxx_crypto_aes_decrypt);
-    BIND_API(dynxx_crypto_aes_gcm_encrypt);
-    BIND_API(dynxx_crypto_aes_gcm_decrypt);
-    BIND_API(dynxx_crypto_rsa_gen_key);
-    BIND_API(dynxx_crypto_rsa_encrypt);
-    BIND_API(dynxx_crypto_rsa_decrypt);
-    BIND_API(dynxx_crypto_hash_md5);
-    BIND_API(dynxx_crypto_hash_sha1);
-    BIND_API(dynxx_crypto_hash_sha256);
-    BIND_API(dynxx_crypto_base64_encode);
-    BIND_API(dynxx_crypto_base64_decode);
-
-    BIND_API(dynxx_z_zip_init);
-    BIND_API(dynxx_z_zip_input);
-    BIND_API(dynxx_z_zip_process_do);
-    BIND_API(dynxx_z_zip_process_finished);
-    BIND_API(dynxx_z_zip_release);
-    BIND_API(dynxx_z_unzip_init);
-    BIND_API(dynxx_z_unzip_input);
-    BIND_API(dynxx_z_unzip_process_do);
-    BIND_API(dynxx_z_unzip_process_finished);
-    BIND_API(dynxx_z_unzip_release);
-    BIND_API(dynxx_z_bytes_zip);
-    BIND_API(dynxx_z_bytes_unzip);
+static JSValue dynxx_z_bytes_unzipB(JS_FUNC_PARAMS) {
+    const auto vm = JSVM::fromContext(ctx);
+    DEF_JS_FUNC_CHECK_VM(vm);
+    const auto in = ARG_BYTES(0);
+    return vm->newPromiseBytes([inBytes = Bytes(in.begin(), in.end()),
+                                bufferSize = static_cast<size_t>(ARG_INT(1, DynXXZDefaultBufferSize)),
+                                format = static_cast<DynXXZFormatX>(ARG_INT(2, static_cast<int64_t>(DynXXZFormatX::ZLib)))] {
+        return dynxxZBytesUnzip(inBytes, bufferSize, format);
+    }, DynXX::Core::Concurrent::TaskPriority::Low);
 }
 
+// JS API - Typed
+
+DEF_API_TYPED(dynxx_store_sqlite_open, dynxxStoreSqliteOpen)
+DEF_API_TYPED(dynxx_store_sqlite_query_read_row, dynxxStoreSqliteQueryReadRow)
+DEF_API_TYPED(dynxx_store_sqlite_query_read_column_text, dynxxStoreSqliteQueryReadColumnText)
+DEF_API_TYPED(dynxx_store_sqlite_query_read_column_integer, dynxxStoreSqliteQueryReadColumnInteger)
+DEF_API_TYPED(dynxx_store_sqlite_query_read_column_float, dynxxStoreSqliteQueryReadColumnFloat)
+DEF_API_TYPED(dynxx_store_sqlite_query_drop, dynxxStoreSqliteQueryDrop)
+DEF_API_TYPED(dynxx_store_sqlite_close, dynxxStoreSqliteClose)
+
+DEF_API_TYPED(dynxx_store_kv_open, dynxxStoreKvOpen)
+DEF_API_TYPED(dynxx_store_kv_read_string, dynxxStoreKvReadString)
+DEF_API_TYPED(dynxx_store_kv_write_string, dynxxStoreKvWriteString)
+DEF_API_TYPED(dynxx_store_kv_read_integer, dynxxStoreKvReadInteger)
+DEF_API_TYPED(dynxx_store_kv_write_integer, dynxxStoreKvWriteInteger)
+DEF_API_TYPED(dynxx_store_kv_read_float, dynxxStoreKvReadFloat)
+DEF_API_TYPED(dynxx_store_kv_write_float, dynxxStoreKvWriteFloat)
+DEF_API_TYPED(dynxx_store_kv_all_keys, dynxxStoreKvAllKeys)
+DEF_API_TYPED(dynxx_store_kv_contains, dynxxStoreKvContains)
+DEF_API_TYPED(dynxx_store_kv_remove, dynxxStoreKvRemove)
+DEF_API_TYPED(dynxx_store_kv_clear, dynxxStoreKvClear)
+DEF_API_TYPED(dynxx_store_kv_close, dynxxStoreKvClose)
+
+DEF_API_TYPED(dynxx_coding_case_upper, dynxxCodingCaseUpper)
+DEF_API_TYPED(dynxx_coding_case_lower, dynxxCodingCaseLower)
+
+// JS API - Binding
+
+static const JSCFunctionListEntry apiFuncs[] = {
+    BIND_API(dynxx_call_platform),
+
+    BIND_API(dynxx_get_version),
+    BIND_API(dynxx_root_path),
+
+    BIND_API(dynxx_log_print),
+
+    BIND_API(dynxx_device_type),
+    BIND_API(dynxx_device_name),
+    BIND_API(dynxx_device_manufacturer),
+    BIND_API(dynxx_device_os_version),
+    BIND_API(dynxx_device_cpu_arch),
+
+    BIND_API(dynxx_net_http_request),
+    BIND_API(dynxx_net_http_download),
+
+    BIND_API(dynxx_store_sqlite_open),
+    BIND_API(dynxx_store_sqlite_execute),
+    BIND_API(dynxx_store_sqlite_query_do),
+    BIND_API(dynxx_store_sqlite_query_read_row),
+    BIND_API(dynxx_store_sqlite_query_read_column_text),
+    BIND_API(dynxx_store_sqlite_query_read_column_integer),
+    BIND_API(dynxx_store_sqlite_query_read_column_float),
+    BIND_API(dynxx_store_sqlite_query_drop),
+    BIND_API(dynxx_store_sqlite_close),
+
+    BIND_API(dynxx_store_kv_open),
+    BIND_API(dynxx_store_kv_read_string),
+    BIND_API(dynxx_store_kv_write_string),
+    BIND_API(dynxx_store_kv_read_integer),
+    BIND_API(dynxx_store_kv_write_integer),
+    BIND_API(dynxx_store_kv_read_float),
+    BIND_API(dynxx_store_kv_write_float),
+    BIND_API(dynxx_store_kv_all_keys),
+    BIND_API(dynxx_store_kv_contains),
+    BIND_API(dynxx_store_kv_remove),
+    BIND_API(dynxx_store_kv_clear),
+    BIND_API(dynxx_store_kv_close),
+
+    BIND_API(dynxx_coding_hex_bytes2str),
+    BIND_API(dynxx_coding_hex_str2bytes),
+    BIND_API(dynxx_coding_bytes2str),
+    BIND_API(dynxx_coding_str2bytes),
+    BIND_API(dynxx_coding_case_upper),
+    BIND_API(dynxx_coding_case_lower),
+
+    BIND_API(dynxx_crypto_rand),
+    BIND_API(dynxx_crypto_aes_encrypt),
+    BIND_API(dynxx_crypto_aes_decrypt),
+    BIND_API(dynxx_crypto_aes_gcm_encrypt),
+    BIND_API(dynxx_crypto_aes_gcm_decrypt),
+    BIND_API(dynxx_crypto_rsa_gen_key),
+    BIND_API(dynxx_crypto_rsa_encrypt),
+    BIND_API(dynxx_crypto_rsa_decrypt),
+    BIND_API(dynxx_crypto_hash_md5),
+    BIND_API(dynxx_crypto_hash_sha1),
+    BIND_API(dynxx_crypto_hash_sha256),
+    BIND_API(dynxx_crypto_base64_encode),
+    BIND_API(dynxx_crypto_base64_decode),
+
+    BIND_API(dynxx_z_zip_init),
+    BIND_API(dynxx_z_zip_input),
+    BIND_API(dynxx_z_zip_process_do),
+    BIND_API(dynxx_z_zip_process_finished),
+    BIND_API(dynxx_z_zip_release),
+    BIND_API(dynxx_z_unzip_init),
+    BIND_API(dynxx_z_unzip_input),
+    BIND_API(dynxx_z_unzip_process_do),
+    BIND_API(dynxx_z_unzip_process_finished),
+    BIND_API(dynxx_z_unzip_release),
+    BIND_API(dynxx_z_bytes_zip),
+    BIND_API(dynxx_z_bytes_unzip),
+
+    BIND_API_BYTES(dynxx_crypto_rand, 1),
+    BIND_API_BYTES(dynxx_crypto_aes_encrypt, 2),
+    BIND_API_BYTES(dynxx_crypto_aes_decrypt, 2),
+    BIND_API_BYTES(dynxx_crypto_aes_gcm_encrypt, 5),
+    BIND_API_BYTES(dynxx_crypto_aes_gcm_decrypt, 5),
+    BIND_API_BYTES(dynxx_crypto_rsa_encrypt, 3),
+    BIND_API_BYTES(dynxx_crypto_rsa_decrypt, 3),
+    BIND_API_BYTES(dynxx_crypto_hash_md5, 1),
+    BIND_API_BYTES(dynxx_crypto_hash_sha1, 1),
+    BIND_API_BYTES(dynxx_crypto_hash_sha256, 1),
+    BIND_API_BYTES(dynxx_crypto_base64_encode, 2),
+    BIND_API_BYTES(dynxx_crypto_base64_decode, 2),
+
+    BIND_API_BYTES(dynxx_z_zip_input, 3),
+    BIND_API_BYTES(dynxx_z_zip_process_do, 1),
+    BIND_API_BYTES(dynxx_z_unzip_input, 3),
+    BIND_API_BYTES(dynxx_z_unzip_process_do, 1),
+    BIND_API_BYTES(dynxx_z_bytes_zip, 4),
+    BIND_API_BYTES(dynxx_z_bytes_unzip, 3),
+
+    BIND_API_TYPED(dynxx_store_sqlite_open, dynxxStoreSqliteOpen),
+    BIND_API_TYPED(dynxx_store_sqlite_query_read_row, dynxxStoreSqliteQueryReadRow),
+    BIND_API_TYPED(dynxx_store_sqlite_query_read_column_text, dynxxStoreSqliteQueryReadColumnText),
+    BIND_API_TYPED(dynxx_store_sqlite_query_read_column_integer, dynxxStoreSqliteQueryReadColumnInteger),
+    BIND_API_TYPED(dynxx_store_sqlite_query_read_column_float, dynxxStoreSqliteQueryReadColumnFloat),
+    BIND_API_TYPED(dynxx_store_sqlite_query_drop, dynxxStoreSqliteQueryDrop),
+    BIND_API_TYPED(dynxx_store_sqlite_close, dynxxStoreSqliteClose),
+
+    BIND_API_TYPED(dynxx_store_kv_open, dynxxStoreKvOpen),
+    BIND_API_TYPED(dynxx_store_kv_read_string, dynxxStoreKvReadString),
+    BIND_API_TYPED(dynxx_store_kv_write_string, dynxxStoreKvWriteString),
+    BIND_API_TYPED(dynxx_store_kv_read_integer, dynxxStoreKvReadInteger),
+    BIND_API_TYPED(dynxx_store_kv_write_integer, dynxxStoreKvWriteInteger),
+    BIND_API_TYPED(dynxx_store_kv_read_float, dynxxStoreKvReadFloat),
+    BIND_API_TYPED(dynxx_store_kv_write_float, dynxxStoreKvWriteFloat),
+    BIND_API_TYPED(dynxx_store_kv_all_keys, dynxxStoreKvAllKeys),
+    BIND_API_TYPED(dynxx_store_kv_contains, dynxxStoreKvContains),
+    BIND_API_TYPED(dynxx_store_kv_remove, dynxxStoreKvRemove),
+    BIND_API_TYPED(dynxx_store_kv_clear, dynxxStoreKvClear),
+    BIND_API_TYPED(dynxx_store_kv_close, dynxxStoreKvClose),
+
+    BIND_API_TYPED(dynxx_coding_case_upper, dynxxCodingCaseUpper),
+    BIND_API_TYPED(dynxx_coding_case_lower, dynxxCodingCaseLower),
+};
+
 // Inner API
 
 void dynxx_js_init() {
-    if (vm) [[unlikely]] {
+    if (vmPool) [[unlikely]] {
         return;
     }
-    vm = std::make_unique<DynXX::Core::VM::JSVM>();
-    registerFuncs();
+    vmPool = std::make_unique<DynXX::Core::VM::VMPool<JSVM>>([] {
+#if defined(USE_KV) || defined(USE_DB)
+        auto vm = std::make_unique<JSVM>(dynxxRootPath());
+#else
+        auto vm = std::make_unique<JSVM>();
+#endif
+        vm->bindFuncs(apiFuncs);
+        {
+            auto lock = std::scoped_lock(vmConfigMutex);
+            vm->configure(vmConfig);
+        }
+        return vm;
+    });
 }
 
 void dynxx_js_release() {
-    if (!vm) [[unlikely]] {
+    if (!vmPool) [[unlikely]] {
         return;
     }
-    vm.reset();
+    vmPool.reset();
     msgCbk = nullptr;
+    {
+        auto lock = std::scoped_lock(funcHandlesMutex);
+        funcHandles.clear();
+    }
+    vmConfig = {};
 }
 
 #endif
@@ -1,39 +1,129 @@
 #if defined(USE_LUA)
 #include "LuaBridge.hxx"
 
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 
 #include <DynXX/CXX/Macro.hxx>
+#include <DynXX/CXX/DynXX.hxx>
 
 #include "../core/vm/LuaVM.hxx"
+#include "../core/vm/VMPool.hxx"
 #include "ScriptAPI.hxx"
 
 namespace {
-    std::unique_ptr<DynXX::Core::VM::LuaVM> vm = nullptr;
+    using DynXX::Core::VM::LuaVM;
+
+    std::unique_ptr<DynXX::Core::VM::VMPool<LuaVM>> vmPool = nullptr;
+    std::unordered_map<std::string, LuaVM::FuncHandle, TransparentStringHash, std::equal_to<>> funcHandles;
+    LuaVM::FuncHandle nextFuncHandle = 1;
+    std::mutex funcHandlesMutex;
+    std::atomic<size_t> memoryLimit{0};
 
 #define DEF_API(f, T) DEF_LUA_FUNC_##T(f##L, f##S)
 
-#define BIND_API(f) vm->bindFunc(#f, f##L)
+#define BIND_API(f) vm.bindFunc(#f, f##L)
 
     bool loadF(const std::string &f) {
-        if (!vm || f.empty()) [[unlikely]] {
+        if (!vmPool || f.empty()) [[unlikely]] {
             return false;
         }
-        return vm->loadFile(f);
+        return vmPool->load([f](LuaVM &vm) {
+            return vm.loadFile(f);
+        });
     }
 
     bool loadS(const std::string &s) {
-        if (!vm || s.empty()) [[unlikely]] {
+        if (!vmPool || s.empty()) [[unlikely]] {
+            return false;
+        }
+        return vmPool->load([s](LuaVM &vm) {
+            return vm.loadScript(s);
+        });
+    }
+
+    bool loadB(const Bytes &bytes) {
+        if (!vmPool || bytes.empty()) [[unlikely]] {
             return false;
         }
-        return vm->loadScript(s);
+        return vmPool->load([bytes](LuaVM &vm) {
+            return vm.loadBinary(bytes);
+        });
     }
 
     std::optional<std::string> call(std::string_view f, std::string_view ps) {
-        if (!vm || f.empty()) [[unlikely]] {
+        if (!vmPool || f.empty()) [[unlikely]] {
+            return std::nullopt;
+        }
+        return vmPool->with([f, ps](LuaVM &vm) {
+            return vm.callFunc(f, ps);
+        });
+    }
+
+    /// Handles are shared by all states of the pool, failed ones are never reused
+    LuaVM::FuncHandle lookup(std::string_view f) {
+        if (!vmPool || f.empty()) [[unlikely]] {
+            return 0;
+        }
+        auto lock = std::scoped_lock(funcHandlesMutex);
+        if (const auto it = funcHandles.find(f); it != funcHandles.end()) {
+            return it->second;
+        }
+        const auto handle = nextFuncHandle++;
+        auto pinned = true;
+        vmPool->forEach([handle, f, &pinned](LuaVM &vm) {
+            pinned = vm.pinFunc(handle, f) && pinned;
+        });
+        if (!pinned) [[unlikely]] {
+            return 0;
+        }
+        // Pin in the states created later, it does nothing in the existing ones
+        vmPool->load([handle, name = std::string(f)](LuaVM &vm) {
+            return vm.pinFunc(handle, name);
+        });
+        funcHandles.emplace(f, handle);
+        return handle;
+    }
+
+    std::optional<std::string> callRef(const LuaVM::FuncHandle handle, std::string_view ps) {
+        if (!vmPool || handle == 0) [[unlikely]] {
             return std::nullopt;
         }
-        return vm->callFunc(f, ps);
+        return vmPool->with([handle, ps](LuaVM &vm) {
+            return vm.callFunc(handle, ps);
+        });
+    }
+
+    bool setPool(const size_t size, const DynXXVMRoutingX routing) {
+        if (!vmPool) [[unlikely]] {
+            return false;
+        }
+        return vmPool->resize(size, routing);
+    }
+
+    /// Applied to the existing states, and to the ones created by resizing later
+    bool setMemoryLimit(const size_t limit) {
+        if (!vmPool) [[unlikely]] {
+            return false;
+        }
+        memoryLimit = limit;
+        vmPool->forEach([limit](LuaVM &vm) {
+            vm.setMemoryLimit(limit);
+        });
+        return true;
+    }
+
+    std::vector<DynXXLuaMemoryStats> memoryStats() {
+        std::vector<DynXXLuaMemoryStats> stats;
+        if (!vmPool) [[unlikely]] {
+            return stats;
+        }
+        vmPool->forEach([&stats](const LuaVM &vm) {
+            stats.emplace_back(vm.memoryStats());
+        });
+        return stats;
     }
 }
 
@@ -47,10 +137,34 @@ bool dynxxLuaLoadS(const std::string &s) {
     return loadS(s);
 }
 
+bool dynxxLuaLoadB(const Bytes &bytes) {
+    return loadB(bytes);
+}
+
 std::optional<std::string> dynxxLuaCall(std::string_view f, std::string_view ps) {
     return call(f, ps);
 }
 
+size_t dynxxLuaLookup(std::string_view f) {
+    return lookup(f);
+}
+
+std::optional<std::string> dynxxLuaCallRef(size_t ref, std::string_view ps) {
+    return callRef(ref, ps);
+}
+
+bool dynxxLuaSetPool(size_t size, DynXXVMRoutingX routing) {
+    return setPool(size, routing);
+}
+
+bool dynxxLuaSetMemoryLimit(size_t limit) {
+    return setMemoryLimit(limit);
+}
+
+std::vector<DynXXLuaMemoryStats> dynxxLuaMemoryStats() {
+    return memoryStats();
+}
+
 // C API
 
 #if !defined(__EMSCRIPTEN__)
@@ -65,6 +179,11 @@ bool dynxx_lua_loadS(const char *script) {
     return dynxxLuaLoadS(makeStr(script));
 }
 
+EXPORT
+bool dynxx_lua_loadB(const byte *bytes, size_t len) {
+    return dynxxLuaLoadB(makeBytes(bytes, len));
+}
+
 EXPORT
 const char *dynxx_lua_call(const char *f, const char *ps) {
     if (f == nullptr) [[unlikely]] 
@@ -75,6 +194,45 @@ const char *dynxx_lua_call(const char *f, const char *ps) {
     return dupStr(s);
 }
 
+EXPORT
+size_t dynxx_lua_lookup(const char *f) {
+    if (f == nullptr) [[unlikely]] {
+        return 0;
+    }
+    return dynxxLuaLookup(f);
+}
+
+EXPORT
+const char *dynxx_lua_call_ref(size_t ref, const char *ps, size_t ps_len) {
+    const auto s = dynxxLuaCallRef(ref, ps ? std::string_view(ps, ps_len) : std::string_view{}).value_or("");
+    return dupStr(s);
+}
+
+EXPORT
+bool dynxx_lua_set_pool(size_t size, int routing) {
+    return dynxxLuaSetPool(size, static_cast<DynXXVMRoutingX>(routing));
+}
+
+EXPORT
+bool dynxx_lua_set_memory_limit(size_t limit) {
+    return dynxxLuaSetMemoryLimit(limit);
+}
+
+EXPORT
+const char *dynxx_lua_memory_stats() {
+    std::string s = "[";
+    for (const auto &stats : dynxxLuaMemoryStats()) {
+        if (const auto json = stats.toJson(); json.has_value()) [[likely]] {
+            if (s.size() > 1) {
+                s += ",";
+            }
+            s += json.value();
+        }
+    }
+    s += "]";
+    return dupStr(s);
+}
+
 // Lua API - Declaration
 
 DEF_API(dynxx_get_version, STRING)
@@ -150,8 +308,7 @@ DEF_API(dynxx_z_bytes_unzip, STRING)
 
 // Lua API - Binding
 
-static void registerFuncs() {
-    if (!vm) [[unlikely]] return;
+static void registerFuncs(const LuaVM &vm) {
     BIND_API(dynxx_get_version);
     BIND_API(dynxx_root_path);
 
@@ -227,17 +384,30 @@ static void registerFuncs() {
 // Inner API
 
 void dynxx_lua_init() {
-    if (vm) [[unlikely]] {
+    if (vmPool) [[unlikely]] {
         return;
     }
-    vm = std::make_unique<DynXX::Core::VM::LuaVM>();
-    registerFuncs();
+    vmPool = std::make_unique<DynXX::Core::VM::VMPool<LuaVM>>([] {
+#if defined(USE_KV) || defined(USE_DB)
+        auto vm = std::make_unique<LuaVM>(dynxxRootPath());
+#else
+        auto vm = std::make_unique<LuaVM>();
+#endif
+        registerFuncs(*vm);
+        vm->setMemoryLimit(memoryLimit);
+        return vm;
+    });
 }
 
 void dynxx_lua_release() {
-    if (!vm) [[unlikely]] {
+    if (!vmPool) [[unlikely]] {
         return;
     }
-    vm.reset();
+    vmPool.reset();
+    {
+        auto lock = std::scoped_lock(funcHandlesMutex);
+        funcHandles.clear();
+    }
+    memoryLimit = 0;
 }
 #endif
@@ -2,6 +2,7 @@
 
 #include "ScriptAPI.hxx"
 
+#include <charconv>
 #include <functional>
 #if defined(__cpp_lib_ranges)
 #include <ranges>
@@ -10,31 +11,41 @@
 #include <DynXX/CXX/DynXX.hxx>
 #include <DynXX/C/Net.h>
 #include "../core/json/JsonCodec.hxx"
+#include "../core/concurrent/Parallel.hxx"
 
 namespace
 {
     using namespace DynXX::Core::Json;
 
+    /// Same output as `cJSON_PrintUnformatted()` of an int array, without creating a cJSON node per byte
     std::string bytes2json(const BytesView bytes)
     {
         if (bytes.empty()) [[unlikely]]
         {
             return {};
         }
-#if defined(__cpp_lib_ranges)
-        auto intV = bytes 
-            | std::views::transform([](const auto b) { return static_cast<int>(b); })
-            | std::ranges::to<std::vector>();
-#else
-        std::vector<int> intV(bytes.size());
-        std::transform(bytes.begin(), bytes.end(), intV.begin(), [](const auto b) { 
-            return static_cast<int>(b); 
-        });
-#endif
-        const auto cj = cJSON_CreateIntArray(intV.data(), static_cast<int>(intV.size()));
-        const auto json = dynxxJsonToStr(cj);
-        cJSON_Delete(cj);
-        return json.value_or("");
+        auto json = DynXX::Core::Concurrent::parallelReduce(DynXX::Core::Concurrent::Executor::shared(), 0uz, bytes.size(), std::string("["),
+            [bytes](const size_t begin, const size_t end) {
+                std::string s;
+                s.reserve((end - begin) * 4uz);
+                char buf[4];
+                for (auto i = begin; i < end; i++)
+                {
+                    if (i > 0)
+                    {
+                        s.push_back(',');
+                    }
+                    const auto [ptr, _] = std::to_chars(buf, buf + sizeof(buf), static_cast<int>(bytes[i]));
+                    s.append(buf, ptr);
+                }
+                return s;
+            },
+            [](std::string &&acc, std::string &&chunk) {
+                acc.append(chunk);
+                return std::move(acc);
+            });
+        json.push_back(']');
+        return json;
     }
 
     std::string strArray2json(const std::vector<std::string> &v)
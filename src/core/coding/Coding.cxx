@@ -4,9 +4,10 @@
 #include <charconv>
 #if defined(__cpp_lib_ranges)
 #include <ranges>
-#include <numeric>
 #endif
 
+#include "../concurrent/Parallel.hxx"
+
 std::string DynXX::Core::Coding::Case::upper(std::string_view str)
 {
     std::string s(str);
@@ -53,30 +54,14 @@ std::string DynXX::Core::Coding::Hex::bytes2str(BytesView bytes)
         }
     };
 
-#if defined(__cpp_lib_ranges)
-#if defined(__cpp_lib_ranges_enumerate)
-    auto hexView = bytes | std::ranges::views::enumerate
-#else
-    auto indices = std::views::iota(size_t{0}, bytes.size());
-    auto hexView = std::views::zip(indices, bytes)
-#endif
-        | std::ranges::views::transform([&str, &transF](const auto& pair) {
-            const auto& [idx, b] = pair;
-            transF(b, &str[idx * 2]);
-            return std::string_view(&str[idx * 2], 2);
-        });
-    return std::accumulate(hexView.begin(), hexView.end(), std::string{},
-        [](std::string&& acc, std::string_view sv) {
-            return std::move(acc) + std::string(sv);
-        });
-#else
-    size_t idx = 0;
-    for (const auto& b : bytes) {
-        transF(b, &str[idx * 2]);
-        idx++;
-    }
+    // Every byte maps to its own 2 chars, so large buffers are split across cores
+    Concurrent::parallelFor(Concurrent::Executor::shared(), 0uz, bytes.size(), [bytes, &str, &transF](const size_t begin, const size_t end) {
+        for (auto idx = begin; idx < end; idx++)
+        {
+            transF(bytes[idx], &str[idx * 2]);
+        }
+    });
     return str;
-#endif
 }
 
 Bytes DynXX::Core::Coding::Hex::str2bytes(const std::string &str)
@@ -1,139 +1,653 @@
 #include "Executor.hxx"
+#include "ThreadUtil.hxx"
+
+#include <algorithm>
 
 #include <DynXX/CXX/Log.hxx>
 
+namespace
+{
+    using namespace DynXX::Core::Concurrent;
+
+    constexpr auto WorkerQueueCapacity = 256uz;
+    constexpr auto SharedIdleTimeoutMicroSecs = 30'000'000uz;
+    /// Blocking I/O workers mostly wait, so there may be more of them than CPU cores
+    constexpr auto BlockingIOMaxWorkerCount = 32uz;
+
+    std::mutex sharedConfigMutex;
+    bool sharedCreated = false;
+    ExecutorConfig sharedConfig{
+        .minWorkerCount = 1uz,
+        .maxWorkerCount = 0uz,
+        .idleTimeoutMicroSecs = SharedIdleTimeoutMicroSecs,
+        .growQueueDepth = 1uz,
+        .workStealing = true
+    };
+
+    constexpr auto lanePos(const TaskPriority priority)
+    {
+        return static_cast<size_t>(priority);
+    }
+
+    uint64_t microSecsBetween(const TaskClock::time_point from, const TaskClock::time_point to)
+    {
+        if (to <= from) [[unlikely]]
+        {
+            return 0;
+        }
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(to - from).count());
+    }
+}
+
 // - Worker
 
-DynXX::Core::Concurrent::Worker::Worker() : Worker(1000uz)
+DynXX::Core::Concurrent::Worker::Worker() : Worker(0uz)
+{
+}
+
+DynXX::Core::Concurrent::Worker::Worker(size_t idleTimeoutMicroSecs) : Worker(idleTimeoutMicroSecs, nullptr, nullptr, nullptr)
+{
+}
+
+DynXX::Core::Concurrent::Worker::Worker(size_t idleTimeoutMicroSecs, StealF &&stealF, RetireF &&retireF, StartF &&startF) : Worker(idleTimeoutMicroSecs, std::move(stealF), std::move(retireF), std::move(startF), WorkerQueueCapacity)
 {
 }
 
-DynXX::Core::Concurrent::Worker::Worker(size_t sleepMicroSecs) : sleepMicroSecs{sleepMicroSecs}
+DynXX::Core::Concurrent::Worker::Worker(size_t idleTimeoutMicroSecs, StealF &&stealF, RetireF &&retireF, StartF &&startF, size_t queueCapacity) : idleTimeoutMicroSecs{idleTimeoutMicroSecs},
+    stealF{std::move(stealF)}, retireF{std::move(retireF)}, lanes{Lane{queueCapacity}, Lane{queueCapacity}, Lane{queueCapacity}}
 {
 #if defined(__cpp_lib_jthread)
-    this->thread = std::jthread([this](std::stop_token stoken) {
-        while (!stoken.stop_requested())
+    this->thread = std::jthread([this, startF = std::move(startF)](std::stop_token stoken) {
+        const auto stopRequested = [&stoken]() { return stoken.stop_requested(); };
 #else
-    this->thread = std::thread([this]() {
-        while (!shouldStop.load())
+    this->thread = std::thread([this, startF = std::move(startF)]() {
+        const auto stopRequested = [this]() { return this->shouldStop.load(); };
 #endif
+        if (startF)
         {
-            auto lock = std::unique_lock(this->mutex);
-            // Wait for tasks or stop signal
-            this->cv.wait(lock, [this
-#if defined(__cpp_lib_jthread)
-                , &stoken
-#endif
-                ]() {
-                return !this->taskQueue.empty() || 
-#if defined(__cpp_lib_jthread)
-                stoken.stop_requested()
-#else
-                shouldStop.load()
-#endif
-                ;
-            });
-            
-            if (
-#if defined(__cpp_lib_jthread)
-                stoken.stop_requested()
-#else
-                shouldStop.load()
-#endif
-            ) 
-            {
-                break;
-            }
+            startF();
+        }
 
-            if (taskQueue.empty()) [[unlikely]] 
+        while (!stopRequested())
+        {
+            Job job;
+            if (!this->take(job, TaskPriority::Low))
             {
-                continue;
+                // Look idle before the last steal attempt: a job submitted to a busy worker after this attempt
+                // sees this worker idle and wakes it up, an early wakeup is kept by the Parker
+                this->idle = true;
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (!this->stealF || !this->stealF(*this, job))
+                {
+                    // Nothing to run: park until new jobs, wakeup (to steal), idle timeout or stop signal
+                    if (this->park())
+                    {
+                        break;
+                    }
+                    continue;
+                }
+                this->idle = false;
+                this->stolenCount.fetch_add(1, std::memory_order_relaxed);
             }
 
-            auto func = std::move(taskQueue.front());
-            taskQueue.pop();
-            lock.unlock();
-
-            if (func) [[likely]] 
-            {
-                dynxxLogPrintF(DynXXLogLevelX::Debug, "Worker@{} run task on thread:{}", reinterpret_cast<uintptr_t>(this), currentThreadId());
-                func();
-            }
+            this->run(std::move(job));
         }
     });
 }
 
 DynXX::Core::Concurrent::Worker::~Worker()
+{
+    this->stop();
+}
+
+void DynXX::Core::Concurrent::Worker::stop()
 {
 #if defined(__cpp_lib_jthread)
-    // jthread automatically handles stop request and join
+    this->thread.request_stop();
 #else
+    this->shouldStop = true;
+#endif
+    this->parker.unpark();
+
+    if (this->thread.joinable())
     {
-        auto lock = std::scoped_lock(this->mutex);
-        this->shouldStop = true;
+        this->thread.join();
     }
-    this->cv.notify_one();
-    
-    if (this->thread.joinable()) 
+}
+
+bool DynXX::Core::Concurrent::Worker::park()
+{
+    this->idle = true;
+    if (this->idleTimeoutMicroSecs == 0 || !this->retireF)
     {
-        this->thread.join();
+        this->parker.park();
+        this->idle = false;
+        return false;
     }
-#endif
+
+    const auto idleSince = TaskClock::now();
+    this->parker.parkFor(this->idleTimeoutMicroSecs);
+    if (TaskClock::now() - idleSince >= std::chrono::microseconds(this->idleTimeoutMicroSecs) && this->pendingCount() == 0)
+    {
+        // Stay `idle` if retired, the executor will never pick it again
+        if (this->retireF(*this))
+        {
+            return true;
+        }
+    }
+    this->idle = false;
+    return false;
+}
+
+void DynXX::Core::Concurrent::Worker::run(Job &&job)
+{
+    const auto startTime = TaskClock::now();
+    this->waitTime.record(microSecsBetween(job.enqueueTime, startTime));
+
+    if (job.deadline.has_value() && startTime > job.deadline.value()) [[unlikely]]
+    {
+        dynxxLogPrintF(DynXXLogLevelX::Warn, "Worker@{} drop expired task, priority:{}", reinterpret_cast<uintptr_t>(this), lanePos(job.priority));
+        this->expiredCount.fetch_add(1, std::memory_order_relaxed);
+        if (job.onExpired)
+        {
+            job.onExpired();
+        }
+        return;
+    }
+
+    if (job.task) [[likely]]
+    {
+        dynxxLogPrintF(DynXXLogLevelX::Debug, "Worker@{} run task on thread:{}", reinterpret_cast<uintptr_t>(this), currentThreadId());
+        job.task();
+    }
+    this->runTime.record(microSecsBetween(startTime, TaskClock::now()));
+    this->executedCount.fetch_add(1, std::memory_order_relaxed);
 }
 
-void DynXX::Core::Concurrent::Worker::sleep() const
+bool DynXX::Core::Concurrent::Worker::take(Job &job, TaskPriority lowest)
 {
-    DynXX::Core::Concurrent::sleep(this->sleepMicroSecs);
+    // Lanes are always drained from the most urgent one
+    for (auto pos = lanePos(TaskPriority::High); pos <= lanePos(lowest); pos++)
+    {
+        auto &lane = this->lanes[pos];
+        if (lane.count.load() == 0)
+        {
+            continue;
+        }
+        if (lane.queue.tryPop(job)) [[likely]]
+        {
+            lane.count.fetch_sub(1);
+            return true;
+        }
+        if (lane.overflowCount.load() == 0) [[likely]]
+        {
+            continue;
+        }
+
+        auto lock = std::scoped_lock(lane.overflowMutex);
+        if (lane.overflowQueue.empty())
+        {
+            continue;
+        }
+        job = std::move(lane.overflowQueue.front());
+        lane.overflowQueue.pop_front();
+        lane.overflowCount.fetch_sub(1);
+        lane.count.fetch_sub(1);
+        return true;
+    }
+    return false;
+}
+
+bool DynXX::Core::Concurrent::Worker::steal(Job &job, TaskPriority lowest)
+{
+    return this->take(job, lowest);
+}
+
+size_t DynXX::Core::Concurrent::Worker::pendingCount() const
+{
+    return this->pendingCount(TaskPriority::Low);
+}
+
+size_t DynXX::Core::Concurrent::Worker::pendingCount(TaskPriority lowest) const
+{
+    auto count = 0uz;
+    for (auto pos = lanePos(TaskPriority::High); pos <= lanePos(lowest); pos++)
+    {
+        count += this->lanes[pos].count.load(std::memory_order_relaxed);
+    }
+    return count;
+}
+
+bool DynXX::Core::Concurrent::Worker::isIdle() const
+{
+    return this->idle.load(std::memory_order_relaxed);
+}
+
+DynXX::Core::Concurrent::WorkerStats DynXX::Core::Concurrent::Worker::stats() const
+{
+    WorkerStats stats{
+        .idle = this->isIdle(),
+        .executedCount = this->executedCount.load(std::memory_order_relaxed),
+        .stolenCount = this->stolenCount.load(std::memory_order_relaxed),
+        .expiredCount = this->expiredCount.load(std::memory_order_relaxed),
+        .waitTime = this->waitTime.snapshot(),
+        .runTime = this->runTime.snapshot()
+    };
+    for (auto pos = 0uz; pos < TaskPriorityCount; pos++)
+    {
+        stats.pendingCount[pos] = this->lanes[pos].count.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+void DynXX::Core::Concurrent::WorkerStats::merge(const WorkerStats &other)
+{
+    for (auto pos = 0uz; pos < TaskPriorityCount; pos++)
+    {
+        this->pendingCount[pos] += other.pendingCount[pos];
+    }
+    this->executedCount += other.executedCount;
+    this->stolenCount += other.stolenCount;
+    this->expiredCount += other.expiredCount;
+    this->waitTime.merge(other.waitTime);
+    this->runTime.merge(other.runTime);
+}
+
+void DynXX::Core::Concurrent::Worker::wakeup()
+{
+    this->parker.unpark();
 }
 
 DynXX::Core::Concurrent::Worker& DynXX::Core::Concurrent::Worker::operator>>(TaskT&& task)
 {
+    return *this >> Job{.task = std::move(task)};
+}
+
+DynXX::Core::Concurrent::Worker& DynXX::Core::Concurrent::Worker::operator>>(Job&& job)
+{
+    job.enqueueTime = TaskClock::now();
+    auto &lane = this->lanes[lanePos(job.priority)];
+    lane.count.fetch_add(1);
+    if (!lane.queue.tryPush(std::move(job))) [[unlikely]]
     {
-        auto lock = std::scoped_lock(this->mutex);
-        this->taskQueue.emplace(std::move(task));
-        dynxxLogPrintF(DynXXLogLevelX::Debug, "Worker@{} taskCount:{}", reinterpret_cast<uintptr_t>(this), this->taskQueue.size());
+        auto lock = std::scoped_lock(lane.overflowMutex);
+        lane.overflowQueue.emplace_back(std::move(job));
+        lane.overflowCount.fetch_add(1);
+    }
+
+    this->parker.unpark();
+
+    dynxxLogPrintF(DynXXLogLevelX::Debug, "Worker@{} taskCount:{}", reinterpret_cast<uintptr_t>(this), this->pendingCount());
+
+    return *this;
+}
+
+DynXX::Core::Concurrent::Worker& DynXX::Core::Concurrent::Worker::operator>>(std::span<Job> jobs)
+{
+    if (jobs.empty()) [[unlikely]]
+    {
+        return *this;
+    }
+
+    const auto now = TaskClock::now();
+    for (auto &job : jobs)
+    {
+        job.enqueueTime = now;
+        auto &lane = this->lanes[lanePos(job.priority)];
+        lane.count.fetch_add(1);
+        if (!lane.queue.tryPush(std::move(job))) [[unlikely]]
+        {
+            auto lock = std::scoped_lock(lane.overflowMutex);
+            lane.overflowQueue.emplace_back(std::move(job));
+            lane.overflowCount.fetch_add(1);
+        }
     }
-    
-    this->cv.notify_one();
-    
+
+    this->parker.unpark();
+
+    dynxxLogPrintF(DynXXLogLevelX::Debug, "Worker@{} batchSize:{} taskCount:{}", reinterpret_cast<uintptr_t>(this), jobs.size(), this->pendingCount());
+
     return *this;
 }
 
 // - Executor
 
-DynXX::Core::Concurrent::Executor::Executor() : Executor(0uz, 1000uz)
+DynXX::Core::Concurrent::Executor::Executor() : Executor(ExecutorConfig{})
 {
 }
 
-DynXX::Core::Concurrent::Executor::Executor(size_t workerPoolCapacity, size_t sleepMicroSecs) : workerPoolCapacity{workerPoolCapacity}, sleepMicroSecs{sleepMicroSecs}
+DynXX::Core::Concurrent::Executor::Executor(const ExecutorConfig &config) : config{config}
 {
-    if (this->workerPoolCapacity == 0)
+    if (this->config.maxWorkerCount == 0)
+    {
+        // `hardware_concurrency()` may be unknown
+        this->config.maxWorkerCount = std::max(countCPUCore(), 1u);
+    }
+    this->config.minWorkerCount = std::min(this->config.minWorkerCount, this->config.maxWorkerCount);
+    this->config.growQueueDepth = std::max(this->config.growQueueDepth, 1uz);
+    this->reservedWorkerCount = this->config.maxWorkerCount > 1 ? 1uz : 0uz;
+    this->workerPool.reserve(this->config.maxWorkerCount);
+
+    auto lock = std::scoped_lock(this->mutex);
+    while (this->workerPool.size() < this->config.minWorkerCount)
     {
-        this->workerPoolCapacity = countCPUCore();
+        this->addWorker();
     }
-    this->workerPool.reserve(this->workerPoolCapacity);
+}
+
+DynXX::Core::Concurrent::Executor &DynXX::Core::Concurrent::Executor::shared()
+{
+    // Never destroyed, to stay usable while other static objects are being destroyed at exit
+    static auto *executor = [] {
+        auto lock = std::scoped_lock(sharedConfigMutex);
+        sharedCreated = true;
+        return new Executor(sharedConfig);
+    }();
+    return *executor;
+}
+
+DynXX::Core::Concurrent::Executor &DynXX::Core::Concurrent::Executor::blockingIO()
+{
+    // Never destroyed, same as the shared one
+    static auto *executor = new Executor(ExecutorConfig{
+        .minWorkerCount = 0uz,
+        .maxWorkerCount = BlockingIOMaxWorkerCount,
+        .idleTimeoutMicroSecs = SharedIdleTimeoutMicroSecs,
+        .growQueueDepth = 1uz,
+        .threadNamePrefix = "DynXX-IO"
+    });
+    return *executor;
+}
+
+bool DynXX::Core::Concurrent::Executor::setSharedConfig(const ExecutorConfig &config)
+{
+    auto lock = std::scoped_lock(sharedConfigMutex);
+    if (sharedCreated)
+    {
+        dynxxLogPrint(DynXXLogLevelX::Warn, "Executor shared config can not be changed after created");
+        return false;
+    }
+    sharedConfig = config;
+    return true;
+}
+
+DynXX::Core::Concurrent::ExecutorStats DynXX::Core::Concurrent::Executor::stats() const
+{
+    auto lock = std::scoped_lock(this->mutex);
+
+    ExecutorStats stats{
+        .workerCount = this->workerPool.size(),
+        .minWorkerCount = this->config.minWorkerCount,
+        .maxWorkerCount = this->config.maxWorkerCount,
+        .createdWorkerCount = this->createdWorkerCount,
+        .retiredWorkerCount = this->retiredWorkerCount,
+        .submittedCount = this->submittedCount,
+        .total = this->retiredStats,
+        .workers = {}
+    };
+    stats.workers.reserve(this->workerPool.size());
+    for (const auto &worker : this->workerPool)
+    {
+        stats.total.merge(stats.workers.emplace_back(worker->stats()));
+    }
+    return stats;
 }
 
 DynXX::Core::Concurrent::Executor::~Executor()
 {
-    this->workerPool.clear();
+    // Stop all workers before releasing any of them, since idle workers may still be stealing from the others
+    std::vector<std::unique_ptr<Worker>> workers;
+    {
+        auto lock = std::scoped_lock(this->mutex);
+        workers.swap(this->workerPool);
+        this->retiredWorkers.clear();
+    }
+    for (const auto &worker : workers)
+    {
+        worker->stop();
+    }
+}
+
+bool DynXX::Core::Concurrent::Executor::isReserved(const Worker &worker) const
+{
+    for (auto i = 0uz; i < this->reservedWorkerCount && i < this->workerPool.size(); i++)
+    {
+        if (this->workerPool[i].get() == &worker)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool DynXX::Core::Concurrent::Executor::steal(const Worker &thief, Job &job)
+{
+    auto lock = std::scoped_lock(this->mutex);
+
+    const auto lowest = this->isReserved(thief) ? TaskPriority::Normal : TaskPriority::Low;
+    Worker *victim = nullptr;
+    auto maxPendingCount = 0uz;
+    for (const auto &worker : this->workerPool)
+    {
+        if (worker.get() == &thief)
+        {
+            continue;
+        }
+        if (const auto pendingCount = worker->pendingCount(lowest); pendingCount > maxPendingCount)
+        {
+            maxPendingCount = pendingCount;
+            victim = worker.get();
+        }
+    }
+
+    if (victim == nullptr || !victim->steal(job, lowest))
+    {
+        return false;
+    }
+    dynxxLogPrintF(DynXXLogLevelX::Debug, "Worker@{} stole task from Worker@{}", reinterpret_cast<uintptr_t>(&thief), reinterpret_cast<uintptr_t>(victim));
+    return true;
+}
+
+bool DynXX::Core::Concurrent::Executor::retire(const Worker &worker)
+{
+    auto lock = std::scoped_lock(this->mutex);
+
+    if (this->workerPool.size() <= this->config.minWorkerCount || worker.pendingCount() > 0)
+    {
+        return false;
+    }
+    // Reservation goes by index, the reserved worker retires only as the last one, or a busy worker would take its place
+    if (this->isReserved(worker) && this->workerPool.size() > 1)
+    {
+        return false;
+    }
+    const auto it = std::ranges::find_if(this->workerPool, [&worker](const auto &w) {
+        return w.get() == &worker;
+    });
+    if (it == this->workerPool.end()) [[unlikely]]
+    {
+        return false;
+    }
+
+    this->retiredStats.merge(worker.stats());
+    this->retiredWorkerCount++;
+
+    // Can not be released on its own thread, will be joined on the next submission
+    this->retiredWorkers.emplace_back(std::move(*it));
+    this->workerPool.erase(it);
+    dynxxLogPrintF(DynXXLogLevelX::Debug, "Executor retired idle worker, poolSize:{}", this->workerPool.size());
+    return true;
+}
+
+void DynXX::Core::Concurrent::Executor::wakeupIdleWorker(const Worker &busyWorker, TaskPriority priority) const
+{
+    for (const auto &worker : this->workerPool)
+    {
+        if (worker.get() == &busyWorker || !worker->isIdle())
+        {
+            continue;
+        }
+        if (priority == TaskPriority::Low && this->isReserved(*worker))
+        {
+            continue;
+        }
+        worker->wakeup();
+        return;
+    }
+}
+
+DynXX::Core::Concurrent::Worker& DynXX::Core::Concurrent::Executor::addWorker()
+{
+    Worker::StealF stealF = nullptr;
+    if (this->config.workStealing)
+    {
+        stealF = [this](const Worker &thief, Job &j) {
+            return this->steal(thief, j);
+        };
+    }
+    Worker::RetireF retireF = nullptr;
+    if (this->config.idleTimeoutMicroSecs > 0)
+    {
+        retireF = [this](const Worker &worker) {
+            return this->retire(worker);
+        };
+    }
+
+    Worker::StartF startF = [index = this->createdWorkerCount, prefix = this->config.threadNamePrefix,
+                             affinity = this->config.affinity, onWorkerStart = this->config.onWorkerStart] {
+        if (!prefix.empty())
+        {
+            setCurrentThreadName(prefix + std::to_string(index));
+        }
+        switch (affinity)
+        {
+            case WorkerAffinity::Core:
+                pinCurrentThreadToCore(index % std::max(countCPUCore(), 1u));
+                break;
+            case WorkerAffinity::NumaNode:
+                pinCurrentThreadToNumaNode(index % countNumaNode());
+                break;
+            default:
+                break;
+        }
+        if (onWorkerStart)
+        {
+            onWorkerStart(index);
+        }
+    };
+
+    this->workerPool.emplace_back(std::make_unique<Worker>(this->config.idleTimeoutMicroSecs, std::move(stealF), std::move(retireF), std::move(startF)));
+    this->createdWorkerCount++;
+    dynxxLogPrintF(DynXXLogLevelX::Debug, "Executor created new worker, poolSize:{} minCount:{} maxCount:{} cpuCores:{}",
+                    this->workerPool.size(), this->config.minWorkerCount, this->config.maxWorkerCount, countCPUCore());
+    return *(this->workerPool.back());
+}
+
+DynXX::Core::Concurrent::Worker& DynXX::Core::Concurrent::Executor::pickWorker(TaskPriority priority)
+{
+    // Reserved workers never run `Low` tasks
+    const auto minIndex = priority == TaskPriority::Low ? this->reservedWorkerCount : 0uz;
+
+    while (this->workerPool.size() <= minIndex)
+    {
+        this->addWorker();
+    }
+
+    for (auto i = minIndex; i < this->workerPool.size(); i++)
+    {
+        if (const auto &worker = this->workerPool[i]; worker->isIdle() && worker->pendingCount() == 0)
+        {
+            return *worker;
+        }
+    }
+
+    // All workers are busy, grow the pool if the queue is deep enough
+    const auto maxIndex = priority == TaskPriority::High && this->reservedWorkerCount > 0 ? this->reservedWorkerCount : this->workerPool.size();
+    const auto index = minIndex + this->workerIndex % (maxIndex - minIndex);
+    this->workerIndex++;
+    auto &worker = *(this->workerPool.at(index));
+    if (this->workerPool.size() < this->config.maxWorkerCount && worker.pendingCount() >= this->config.growQueueDepth)
+    {
+        return this->addWorker();
+    }
+    return worker;
 }
 
 DynXX::Core::Concurrent::Executor& DynXX::Core::Concurrent::Executor::operator>>(TaskT&& task)
+{
+    return *this >> Job{.task = std::move(task)};
+}
+
+DynXX::Core::Concurrent::Executor& DynXX::Core::Concurrent::Executor::operator>>(Job&& job)
 {
     auto lock = std::scoped_lock(this->mutex);
 
-    if (this->workerPool.size() < this->workerPoolCapacity)
+    // Join the retired workers, they have exited already
+    this->retiredWorkers.clear();
+
+    this->submittedCount++;
+    const auto priority = job.priority;
+    auto &worker = this->pickWorker(priority);
+    worker >> std::move(job);
+    // Pairs with the fence of a worker going idle: either its last steal attempt sees the job, or it is seen idle here
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    /// The target worker is busy with other tasks, let an idle one steal the new task.
+    if (this->config.workStealing && !worker.isIdle())
     {
-        auto worker = std::make_unique<Worker>(this->sleepMicroSecs);
-        this->workerPool.emplace_back(std::move(worker));
-        dynxxLogPrintF(DynXXLogLevelX::Debug, "Executor created new worker, poolSize:{} poolCapacity:{} cpuCores:{}", 
-                        this->workerPool.size(), this->workerPoolCapacity, countCPUCore());
+        this->wakeupIdleWorker(worker, priority);
     }
-    
-    *(this->workerPool.at(this->workerIndex)) >> std::move(task);
-    
-    this->workerIndex = (this->workerIndex + 1) % this->workerPoolCapacity;
-    
+
     return *this;
-}
\ No newline at end of file
+}
+
+void DynXX::Core::Concurrent::Executor::submitBatch(std::span<TaskT> tasks, TaskPriority priority)
+{
+    std::vector<Job> jobs;
+    jobs.reserve(tasks.size());
+    for (auto &task : tasks)
+    {
+        jobs.emplace_back(Job{.task = std::move(task), .priority = priority});
+    }
+    this->submitBatch(std::span<Job>(jobs));
+}
+
+void DynXX::Core::Concurrent::Executor::submitBatch(std::span<Job> jobs)
+{
+    if (jobs.empty()) [[unlikely]]
+    {
+        return;
+    }
+
+    auto lock = std::scoped_lock(this->mutex);
+
+    this->retiredWorkers.clear();
+    this->submittedCount += jobs.size();
+
+    // Reserved workers never run `Low` tasks
+    const auto hasLow = std::ranges::any_of(jobs, [](const Job &job) {
+        return job.priority == TaskPriority::Low;
+    });
+    const auto minIndex = hasLow ? this->reservedWorkerCount : 0uz;
+
+    // Grow the pool at once, so that the batch can be spread across as many workers as possible
+    while (this->workerPool.size() <= minIndex
+           || (this->workerPool.size() < this->config.maxWorkerCount && this->workerPool.size() - minIndex < jobs.size()))
+    {
+        this->addWorker();
+    }
+
+    // Spread the batch in contiguous chunks, one push (and one wakeup) per worker
+    const auto workerCount = std::min(this->workerPool.size() - minIndex, jobs.size());
+    const auto chunkSize = jobs.size() / workerCount;
+    const auto remainder = jobs.size() % workerCount;
+    auto offset = 0uz;
+    for (auto i = 0uz; i < workerCount; i++)
+    {
+        const auto index = minIndex + (this->workerIndex + i) % (this->workerPool.size() - minIndex);
+        const auto size = chunkSize + (i < remainder ? 1uz : 0uz);
+        *(this->workerPool[index]) >> jobs.subspan(offset, size);
+        offset += size;
+    }
+    this->workerIndex += static_cast<unsigned>(workerCount);
+}
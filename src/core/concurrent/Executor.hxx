@@ -3,13 +3,20 @@
 
 #if defined(__cplusplus)
 
+#include <array>
 #include <atomic>
-#include <condition_variable>
+#include <chrono>
 #include <functional>
-#include <queue>
+#include <deque>
+#include <optional>
+#include <span>
 #include <vector>
 
 #include "ConcurrentUtil.hxx"
+#include "Future.hxx"
+#include "Lock.hxx"
+#include "LockFreeQueue.hxx"
+#include "Metrics.hxx"
 
 namespace DynXX::Core::Concurrent {
     using TaskT = std::
@@ -20,15 +27,122 @@ namespace DynXX::Core::Concurrent {
 #endif
     <void()>;
 
+    enum class TaskPriority : uint8_t {
+        High = 0, // Latency-sensitive work, e.g. interactive script calls; dequeued before other tasks, but never preempts running ones
+        Normal,
+        Low, // Bulk work, e.g. downloads and (un)zip of large data
+    };
+
+    static constexpr auto TaskPriorityCount = 3uz;
+
+    using TaskClock = std::chrono::steady_clock;
+
+    struct Job {
+        TaskT task{nullptr};
+        TaskPriority priority{TaskPriority::Normal};
+        /// The task will be dropped if not started before the deadline
+        std::optional<TaskClock::time_point> deadline{std::nullopt};
+        /// Called instead of `task` if it was dropped for expiration
+        TaskT onExpired{nullptr};
+        /// Set by the Worker receiving the job, to measure the wait time
+        TaskClock::time_point enqueueTime{};
+    };
+
+    struct WorkerStats {
+        bool idle{false};
+        std::array<size_t, TaskPriorityCount> pendingCount{};
+        uint64_t executedCount{0};
+        /// Jobs stolen from other workers, included in `executedCount`
+        uint64_t stolenCount{0};
+        uint64_t expiredCount{0};
+        /// Time between enqueued and started, in micro seconds
+        LatencyHistogram::Snapshot waitTime;
+        /// Time to run, in micro seconds
+        LatencyHistogram::Snapshot runTime;
+
+        void merge(const WorkerStats &other);
+    };
+
+    struct ExecutorStats {
+        size_t workerCount{0uz};
+        size_t minWorkerCount{0uz};
+        size_t maxWorkerCount{0uz};
+        uint64_t createdWorkerCount{0};
+        uint64_t retiredWorkerCount{0};
+        uint64_t submittedCount{0};
+        /// Sum of all workers, including the retired ones
+        WorkerStats total;
+        std::vector<WorkerStats> workers;
+    };
+
+    enum class WorkerAffinity : uint8_t {
+        None = 0,
+        /// Pin each worker to a CPU core, in creation order
+        Core,
+        /// Pin each worker to the CPU cores of a NUMA node, spread across nodes in creation order
+        NumaNode,
+    };
+
+    struct ExecutorConfig {
+        /// Workers kept alive even if idle, created along with the Executor
+        size_t minWorkerCount{0uz};
+        /// Max worker count, `0` means the count of CPU cores
+        size_t maxWorkerCount{0uz};
+        /// Idle workers beyond `minWorkerCount` exit after this timeout, `0` means never
+        size_t idleTimeoutMicroSecs{0uz};
+        /// A new worker is created if no worker is idle and the picked one has at least so many pending jobs
+        size_t growQueueDepth{1uz};
+        /// Whether idle workers steal tasks from the busiest workers or not
+        bool workStealing{false};
+        /// Workers are named with this prefix plus their creation index, empty to not name them
+        std::string threadNamePrefix{"DynXX-W"};
+        WorkerAffinity affinity{WorkerAffinity::None};
+        /// Called on each worker thread before running any task, with the worker creation index,
+        /// e.g. to apply custom placement or thread priority
+        std::function<void(size_t workerIndex)> onWorkerStart{nullptr};
+    };
+
     class
 #if !defined(__cpp_lib_jthread)
             alignas(CacheLineSize)
 #endif
             Worker final {
     public:
+        /**
+         * @brief Callback for an idle worker to steal a job from other workers
+         * @param thief The idle worker
+         * @param job Receives the stolen job
+         * @return Whether a job was stolen
+         */
+        using StealF = std::function<bool(const Worker &thief, Job &job)>;
+
+        /**
+         * @brief Callback for a worker idle for too long to exit
+         * @param worker The idle worker
+         * @return Whether the worker may exit, it must receive no more jobs then
+         */
+        using RetireF = std::function<bool(const Worker &worker)>;
+
+        /**
+         * @brief Callback on the worker thread before running any task, e.g. to name or pin the thread
+         */
+        using StartF = std::function<void()>;
+
         Worker();
 
-        explicit Worker(size_t sleepMicroSecs);
+        explicit Worker(size_t idleTimeoutMicroSecs);
+
+        explicit Worker(size_t idleTimeoutMicroSecs, StealF &&stealF, RetireF &&retireF, StartF &&startF);
+
+        /**
+         * @brief Create a Worker
+         * @param idleTimeoutMicroSecs Idle time before asking `retireF` to exit, `0` means never
+         * @param stealF Callback to steal jobs from other workers while idle, `nullptr` to disable stealing
+         * @param retireF Callback to exit after idle timeout, `nullptr` to never exit before stopped
+         * @param startF Callback on the worker thread when started, `nullptr` to do nothing
+         * @param queueCapacity Capacity of the lock-free queue of each priority, jobs exceeding it go to a locked overflow queue
+         */
+        explicit Worker(size_t idleTimeoutMicroSecs, StealF &&stealF, RetireF &&retireF, StartF &&startF, size_t queueCapacity);
 
         Worker(const Worker &) = delete;
 
@@ -42,11 +156,62 @@ namespace DynXX::Core::Concurrent {
 
         Worker &operator>>(TaskT &&task);
 
+        Worker &operator>>(Job &&job);
+
+        /**
+         * @brief Push a batch of jobs with a single wakeup
+         * @param jobs Jobs to push, will be moved from
+         */
+        Worker &operator>>(std::span<Job> jobs);
+
+        /**
+         * @brief Take the most urgent pending job, called by other (idle) workers
+         * @param job Receives the stolen job
+         * @param lowest The lowest priority acceptable for the thief
+         * @return Whether a job was stolen
+         */
+        [[nodiscard]] bool steal(Job &job, TaskPriority lowest);
+
+        [[nodiscard]] size_t pendingCount() const;
+
+        [[nodiscard]] size_t pendingCount(TaskPriority lowest) const;
+
+        [[nodiscard]] bool isIdle() const;
+
+        [[nodiscard]] WorkerStats stats() const;
+
+        /**
+         * @brief Wake up the worker if it is idle, to let it try stealing
+         */
+        void wakeup();
+
+        /**
+         * @brief Stop the worker and wait for the running task to finish
+         */
+        void stop();
+
     private:
-        const size_t sleepMicroSecs{1000uz};
-        std::mutex mutex;
-        std::condition_variable cv;
-        std::queue<TaskT> taskQueue;
+        struct Lane {
+            explicit Lane(size_t capacity) : queue{capacity} {}
+
+            BoundedMPMCQueue<Job> queue;
+            std::mutex overflowMutex;
+            std::deque<Job> overflowQueue;
+            std::atomic<size_t> overflowCount{0uz};
+            std::atomic<size_t> count{0uz};
+        };
+
+        const size_t idleTimeoutMicroSecs{0uz};
+        const StealF stealF{nullptr};
+        const RetireF retireF{nullptr};
+        std::array<Lane, TaskPriorityCount> lanes;
+        std::atomic<bool> idle{false};
+        std::atomic<uint64_t> executedCount{0};
+        std::atomic<uint64_t> stolenCount{0};
+        std::atomic<uint64_t> expiredCount{0};
+        LatencyHistogram waitTime;
+        LatencyHistogram runTime;
+        Parker parker;
 #if defined(__cpp_lib_jthread)
         std::jthread thread;
 #else
@@ -54,14 +219,53 @@ namespace DynXX::Core::Concurrent {
         std::atomic<bool> shouldStop{false};
 #endif
 
-        void sleep() const;
+        bool take(Job &job, TaskPriority lowest);
+
+        void run(Job &&job);
+
+        /**
+         * @brief Park while idle
+         * @return Whether the worker should exit
+         */
+        bool park();
     };
 
     class Executor final {
     public:
         Executor();
 
-        explicit Executor(size_t workerPoolCapacity, size_t sleepMicroSecs);
+        /**
+         * @brief Create an Executor
+         * @param config Pool sizing & scheduling config
+         * @note With more than one worker, the first worker is reserved for `High` & `Normal` tasks,
+         * so they are never queued behind `Low` ones. Running tasks are not preempted, so a `High` task
+         * may still wait for the tasks already running on all workers.
+         */
+        explicit Executor(const ExecutorConfig &config);
+
+        /**
+         * @brief The process-wide shared Executor, grows with load up to the count of CPU cores,
+         * and reclaims idle workers.
+         * @note Prefer it to a private Executor, so that the thread count does not grow with the count of its users.
+         */
+        static Executor &shared();
+
+        /**
+         * @brief The process-wide Executor for blocking calls (network, disk, compression),
+         * so they never hold the workers of the other Executors.
+         * @note Starts with no worker, grows with load up to a fixed count independent of CPU cores,
+         * and reclaims idle workers.
+         */
+        static Executor &blockingIO();
+
+        /**
+         * @brief Override the config of the shared Executor, e.g. to enable thread affinity
+         * @param config The config
+         * @return `false` if the shared Executor was already created
+         */
+        static bool setSharedConfig(const ExecutorConfig &config);
+
+        [[nodiscard]] ExecutorStats stats() const;
 
         Executor(const Executor &) = delete;
 
@@ -75,12 +279,64 @@ namespace DynXX::Core::Concurrent {
 
         Executor &operator>>(TaskT &&task);
 
+        Executor &operator>>(Job &&job);
+
+        /**
+         * @brief Submit a batch of tasks, spread across workers with one lock and a single wakeup per worker
+         * @param tasks Tasks to submit, will be moved from
+         * @param priority Priority of all the tasks
+         */
+        void submitBatch(std::span<TaskT> tasks, TaskPriority priority = TaskPriority::Normal);
+
+        /**
+         * @brief Submit a batch of jobs, spread across workers with one lock and a single wakeup per worker
+         * @param jobs Jobs to submit, will be moved from
+         */
+        void submitBatch(std::span<Job> jobs);
+
+        /**
+         * @brief Submit a task and get its result asynchronously
+         * @param f The task
+         * @param priority Task priority
+         * @return Future of the task result, use `then()` to chain dependent steps on the completing worker
+         */
+        template<typename F, typename R = std::invoke_result_t<F>>
+        Future<R> submit(F &&f, TaskPriority priority = TaskPriority::Normal)
+        {
+            Promise<R> promise;
+            auto future = promise.future();
+            *this >> Job{
+                .task = [promise = std::move(promise), f = std::forward<F>(f)]() mutable {
+                    promise.setWith(std::move(f));
+                },
+                .priority = priority
+            };
+            return future;
+        }
+
     private:
-        size_t workerPoolCapacity{0uz};
-        size_t sleepMicroSecs{1000uz};
+        ExecutorConfig config;
+        size_t reservedWorkerCount{0uz};
         std::vector<std::unique_ptr<Worker>> workerPool;
-        std::mutex mutex;
+        std::vector<std::unique_ptr<Worker>> retiredWorkers;
+        WorkerStats retiredStats;
+        uint64_t createdWorkerCount{0};
+        uint64_t retiredWorkerCount{0};
+        uint64_t submittedCount{0};
+        mutable std::mutex mutex;
         unsigned workerIndex{0uz};
+
+        bool isReserved(const Worker &worker) const;
+
+        Worker &addWorker();
+
+        Worker &pickWorker(TaskPriority priority);
+
+        bool steal(const Worker &thief, Job &job);
+
+        bool retire(const Worker &worker);
+
+        void wakeupIdleWorker(const Worker &busyWorker, TaskPriority priority) const;
     };
 }
 
@@ -0,0 +1,322 @@
+#ifndef DYNXX_SRC_CORE_CONCURRENT_FUTURE_HXX_
+#define DYNXX_SRC_CORE_CONCURRENT_FUTURE_HXX_
+
+#if defined(__cplusplus)
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "Lock.hxx"
+
+namespace DynXX::Core::Concurrent {
+    template<typename T>
+    class Future;
+
+    template<typename T>
+    class Promise;
+
+    namespace FutureDetail {
+        template<typename T>
+        using ValueT = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+        using ContinuationT = std::
+#if defined(__cpp_lib_move_only_function)
+        move_only_function
+#else
+        function
+#endif
+        <void()>;
+
+        /// The only heap allocation of a Promise/Future pair
+        template<typename T>
+        struct State {
+            SpinLock lock;
+            std::optional<ValueT<T>> value;
+            std::exception_ptr exception{nullptr};
+            ContinuationT continuation{nullptr};
+            std::atomic<bool> ready{false};
+            /// Copies of the Promise, the last one breaks the promise if it was never fulfilled
+            std::atomic<size_t> promiseCount{1};
+        };
+
+        template<typename F, typename T>
+        struct ResultOf {
+            using type = std::invoke_result_t<F, T>;
+        };
+
+        template<typename F>
+        struct ResultOf<F, void> {
+            using type = std::invoke_result_t<F>;
+        };
+    }
+
+    /**
+     * @brief Write side of a Promise/Future pair, fulfilled once by the producer
+     * @note If the last copy is destroyed unfulfilled (e.g. a dropped job), the Future gets a `broken_promise` error.
+     */
+    template<typename T>
+    class Promise final {
+    public:
+        Promise() : state{std::make_shared<FutureDetail::State<T>>()} {}
+
+        Promise(const Promise &other) : state{other.state}
+        {
+            this->retain();
+        }
+
+        Promise &operator=(const Promise &other)
+        {
+            if (this != &other)
+            {
+                this->release();
+                this->state = other.state;
+                this->retain();
+            }
+            return *this;
+        }
+
+        Promise(Promise &&other) noexcept : state{std::move(other.state)} {}
+
+        Promise &operator=(Promise &&other) noexcept
+        {
+            if (this != &other)
+            {
+                this->release();
+                this->state = std::move(other.state);
+            }
+            return *this;
+        }
+
+        ~Promise()
+        {
+            this->release();
+        }
+
+        [[nodiscard]] Future<T> future() const
+        {
+            return Future<T>{this->state};
+        }
+
+        /**
+         * @brief Fulfill the promise, the continuation (if any) runs inline on the current thread
+         */
+        template<typename... Args>
+        void set(Args &&... args)
+        {
+            this->fulfill([&args...](FutureDetail::State<T> &state) {
+                state.value.emplace(std::forward<Args>(args)...);
+            });
+        }
+
+        /**
+         * @brief Fulfill the promise with an exception, rethrown by `Future::get()`
+         */
+        void setException(std::exception_ptr exception)
+        {
+            this->fulfill([&exception](FutureDetail::State<T> &state) {
+                state.exception = std::move(exception);
+            });
+        }
+
+        /**
+         * @brief Fulfill the promise with the result of `f`, or with the exception thrown by it
+         */
+        template<typename F>
+        void setWith(F &&f)
+        {
+            try
+            {
+                if constexpr (std::is_void_v<T>)
+                {
+                    std::invoke(std::forward<F>(f));
+                    this->set();
+                }
+                else
+                {
+                    this->set(std::invoke(std::forward<F>(f)));
+                }
+            }
+            catch (...)
+            {
+                this->setException(std::current_exception());
+            }
+        }
+
+    private:
+        std::shared_ptr<FutureDetail::State<T>> state;
+
+        void retain()
+        {
+            this->state->promiseCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void release()
+        {
+            // Moved from
+            if (!this->state)
+            {
+                return;
+            }
+            if (this->state->promiseCount.fetch_sub(1, std::memory_order_acq_rel) == 1 && !this->state->ready.load(std::memory_order_acquire))
+            {
+                this->setException(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+            }
+            this->state.reset();
+        }
+
+        template<typename F>
+        void fulfill(F &&store)
+        {
+            FutureDetail::ContinuationT continuation{nullptr};
+            {
+                auto lock = std::scoped_lock(this->state->lock);
+                if (this->state->ready.load(std::memory_order_relaxed)) [[unlikely]]
+                {
+                    return;
+                }
+                store(*this->state);
+                this->state->ready.store(true, std::memory_order_release);
+                continuation = std::move(this->state->continuation);
+            }
+            this->state->ready.notify_all();
+
+            if (continuation)
+            {
+                continuation();
+            }
+        }
+    };
+
+    /**
+     * @brief Read side of a Promise/Future pair.
+     * @note Continuations added by `then()` run inline on the thread fulfilling the promise,
+     * or on the caller thread if it was already fulfilled, so chained steps cost no extra queue hop.
+     * @warning Keep continuations short, they block the completing worker.
+     */
+    template<typename T>
+    class Future final {
+    public:
+        Future() = delete;
+
+        Future(const Future &) = delete;
+
+        Future &operator=(const Future &) = delete;
+
+        Future(Future &&) noexcept = default;
+
+        Future &operator=(Future &&) noexcept = default;
+
+        ~Future() = default;
+
+        [[nodiscard]] bool ready() const
+        {
+            return this->state->ready.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief Block the current thread until the promise is fulfilled
+         */
+        void wait() const
+        {
+            while (!this->ready())
+            {
+                this->state->ready.wait(false, std::memory_order_acquire);
+            }
+        }
+
+        /**
+         * @brief Block the current thread until the promise is fulfilled, then take the value
+         * @throw The exception the promise was fulfilled with, `std::future_error` if it was broken
+         * @warning Call it only once, and not together with `then()`.
+         */
+        FutureDetail::ValueT<T> get()
+        {
+            this->wait();
+            if (this->state->exception) [[unlikely]]
+            {
+                std::rethrow_exception(this->state->exception);
+            }
+            return std::move(this->state->value.value());
+        }
+
+        /**
+         * @brief Chain a continuation consuming the value
+         * @param f Called with the value (or nothing for `Future<void>`), skipped if fulfilled with an exception
+         * @return Future of the continuation result, fulfilled with the exception of this one or of `f`
+         * @warning Call it only once, and not together with `get()`.
+         */
+        template<typename F, typename R = typename FutureDetail::ResultOf<F, T>::type>
+        Future<R> then(F &&f)
+        {
+            Promise<R> next;
+            auto nextFuture = next.future();
+
+            // Runs only while a Promise still owns the state, so no need to extend its lifetime here
+            auto continuation = [state = this->state.get(), next = std::move(next), f = std::forward<F>(f)]() mutable {
+                if (state->exception) [[unlikely]]
+                {
+                    next.setException(state->exception);
+                    return;
+                }
+                next.setWith([state, &f]() -> R {
+                    if constexpr (std::is_void_v<T>)
+                    {
+                        return std::invoke(f);
+                    }
+                    else
+                    {
+                        return std::invoke(f, std::move(state->value.value()));
+                    }
+                });
+            };
+
+            {
+                auto lock = std::scoped_lock(this->state->lock);
+                if (!this->state->ready.load(std::memory_order_relaxed))
+                {
+                    this->state->continuation = std::move(continuation);
+                    return nextFuture;
+                }
+            }
+
+            // Already fulfilled, run inline on the caller thread
+            continuation();
+            return nextFuture;
+        }
+
+        /**
+         * @brief Run `f` on the thread fulfilling the promise, without consuming the value
+         * @return `false` if already fulfilled, then `f` is not stored nor called
+         * @warning Call it only once, and not together with `then()`.
+         */
+        [[nodiscard]] bool whenReady(FutureDetail::ContinuationT &&f)
+        {
+            auto lock = std::scoped_lock(this->state->lock);
+            if (this->state->ready.load(std::memory_order_relaxed))
+            {
+                return false;
+            }
+            this->state->continuation = std::move(f);
+            return true;
+        }
+
+    private:
+        friend class Promise<T>;
+
+        explicit Future(std::shared_ptr<FutureDetail::State<T>> state) : state{std::move(state)} {}
+
+        std::shared_ptr<FutureDetail::State<T>> state;
+    };
+}
+
+#endif
+
+#endif // DYNXX_SRC_CORE_CONCURRENT_FUTURE_HXX_
@@ -1,5 +1,33 @@
 #include "Lock.hxx"
 
+#if defined(__linux__)
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+#if defined(__linux__)
+    constexpr int32_t ParkerEmpty = 0;
+    constexpr int32_t ParkerNotified = 1;
+    constexpr int32_t ParkerParked = -1;
+
+    void futexWait(std::atomic<int32_t> &state, const int32_t expected, const timespec *timeout)
+    {
+        syscall(SYS_futex, reinterpret_cast<int32_t *>(&state), FUTEX_WAIT_PRIVATE, expected, timeout, nullptr, 0);
+    }
+
+    void futexWake(std::atomic<int32_t> &state)
+    {
+        syscall(SYS_futex, reinterpret_cast<int32_t *>(&state), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+    }
+#endif
+}
+
+// - SpinLock
+
 void DynXX::Core::Concurrent::SpinLock::lock() 
 {
     while (lockFlag.exchange(true, std::memory_order_acquire));
@@ -9,3 +37,74 @@ void DynXX::Core::Concurrent::SpinLock::unlock()
 {
     lockFlag.store(false, std::memory_order_release);
 }
+
+// - Parker
+
+#if defined(__linux__)
+
+void DynXX::Core::Concurrent::Parker::park()
+{
+    // NOTIFIED -> EMPTY: consume the permit; EMPTY -> PARKED: go to sleep.
+    if (this->state.fetch_sub(1, std::memory_order_acquire) == ParkerNotified)
+    {
+        return;
+    }
+    for (;;)
+    {
+        futexWait(this->state, ParkerParked, nullptr);
+        auto expected = ParkerNotified;
+        if (this->state.compare_exchange_strong(expected, ParkerEmpty, std::memory_order_acquire))
+        {
+            return;
+        }
+    }
+}
+
+void DynXX::Core::Concurrent::Parker::parkFor(size_t microSecs)
+{
+    if (this->state.fetch_sub(1, std::memory_order_acquire) == ParkerNotified)
+    {
+        return;
+    }
+    const timespec timeout{
+        .tv_sec = static_cast<time_t>(microSecs / 1000000uz),
+        .tv_nsec = static_cast<long>(microSecs % 1000000uz) * 1000L
+    };
+    futexWait(this->state, ParkerParked, &timeout);
+    this->state.exchange(ParkerEmpty, std::memory_order_acquire);
+}
+
+void DynXX::Core::Concurrent::Parker::unpark()
+{
+    if (this->state.exchange(ParkerNotified, std::memory_order_release) == ParkerParked)
+    {
+        futexWake(this->state);
+    }
+}
+
+#else
+
+void DynXX::Core::Concurrent::Parker::park()
+{
+    auto lock = std::unique_lock(this->mutex);
+    this->cv.wait(lock, [this]() { return this->notified; });
+    this->notified = false;
+}
+
+void DynXX::Core::Concurrent::Parker::parkFor(size_t microSecs)
+{
+    auto lock = std::unique_lock(this->mutex);
+    this->cv.wait_for(lock, std::chrono::microseconds(microSecs), [this]() { return this->notified; });
+    this->notified = false;
+}
+
+void DynXX::Core::Concurrent::Parker::unpark()
+{
+    {
+        auto lock = std::scoped_lock(this->mutex);
+        this->notified = true;
+    }
+    this->cv.notify_one();
+}
+
+#endif
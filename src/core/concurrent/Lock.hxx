@@ -4,6 +4,9 @@
 #if defined(__cplusplus)
 
 #include <atomic>
+#if !defined(__linux__)
+#include <condition_variable>
+#endif
 
 #include "ConcurrentUtil.hxx"
 
@@ -27,6 +30,47 @@ private:
     std::atomic<bool> lockFlag = {false};
 };
 
+/**
+ * @brief Park a thread until another thread unparks it.
+ * @note Holds a single permit: an `unpark()` before `park()` makes the next `park()` return immediately.
+ * @note Uses `futex` on Linux/Android, so `unpark()` costs only an atomic exchange while nobody is parked.
+ */
+class alignas(CacheLineSize) Parker final
+{
+public:
+    Parker() = default;
+    Parker(const Parker &) = delete;
+    Parker &operator=(const Parker &) = delete;
+    Parker(Parker &&) = delete;
+    Parker &operator=(Parker &&) = delete;
+    ~Parker() = default;
+
+    /**
+     * @brief Block the current thread until unparked, may return spuriously
+     */
+    void park();
+
+    /**
+     * @brief Block the current thread until unparked or timeout, may return spuriously
+     * @param microSecs Timeout in micro seconds
+     */
+    void parkFor(size_t microSecs);
+
+    /**
+     * @brief Wake up the parked thread, or make the next `park()` return immediately
+     */
+    void unpark();
+
+private:
+#if defined(__linux__)
+    std::atomic<int32_t> state = {0};
+#else
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool notified = {false};
+#endif
+};
+
 }
 
 #endif
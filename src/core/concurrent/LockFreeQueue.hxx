@@ -0,0 +1,143 @@
+#ifndef DYNXX_SRC_CORE_CONCURRENT_LOCK_FREE_QUEUE_HXX_
+#define DYNXX_SRC_CORE_CONCURRENT_LOCK_FREE_QUEUE_HXX_
+
+#if defined(__cplusplus)
+
+#include <atomic>
+#include <memory>
+#include <bit>
+
+#include "ConcurrentUtil.hxx"
+
+namespace DynXX::Core::Concurrent {
+
+    /**
+     * @brief Bounded MPMC queue, based on Dmitry Vyukov's algorithm.
+     * @note Every producer/consumer claims a slot with one CAS, no lock is required.
+     */
+    template<typename T>
+        requires std::is_default_constructible_v<T> && std::is_move_assignable_v<T>
+    class BoundedMPMCQueue final {
+    public:
+        BoundedMPMCQueue() = delete;
+
+        /**
+         * @param capacity Queue capacity, will be rounded up to a power of 2
+         */
+        explicit BoundedMPMCQueue(size_t capacity) :
+            capacity{std::bit_ceil(capacity < 2uz ? 2uz : capacity)},
+            mask{this->capacity - 1},
+            cells{std::make_unique<Cell[]>(this->capacity)}
+        {
+            for (auto i = 0uz; i < this->capacity; i++)
+            {
+                this->cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        BoundedMPMCQueue(const BoundedMPMCQueue &) = delete;
+
+        BoundedMPMCQueue &operator=(const BoundedMPMCQueue &) = delete;
+
+        BoundedMPMCQueue(BoundedMPMCQueue &&) = delete;
+
+        BoundedMPMCQueue &operator=(BoundedMPMCQueue &&) = delete;
+
+        ~BoundedMPMCQueue() = default;
+
+        /**
+         * @brief Push an element
+         * @param v The element, will not be moved if the queue is full
+         * @return `false` if the queue is full
+         */
+        [[nodiscard]] bool tryPush(T &&v)
+        {
+            Cell *cell;
+            auto pos = this->enqueuePos.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                cell = &this->cells[pos & this->mask];
+                const auto seq = cell->sequence.load(std::memory_order_acquire);
+                if (const auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos); diff == 0)
+                {
+                    if (this->enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        break;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    pos = this->enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+            cell->data = std::move(v);
+            cell->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Pop an element
+         * @param v Receives the element
+         * @return `false` if the queue is empty
+         */
+        [[nodiscard]] bool tryPop(T &v)
+        {
+            Cell *cell;
+            auto pos = this->dequeuePos.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                cell = &this->cells[pos & this->mask];
+                const auto seq = cell->sequence.load(std::memory_order_acquire);
+                if (const auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1); diff == 0)
+                {
+                    if (this->dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        break;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    pos = this->dequeuePos.load(std::memory_order_relaxed);
+                }
+            }
+            v = std::move(cell->data);
+            cell->data = T{}; // Release resources captured by the element as early as possible
+            cell->sequence.store(pos + this->mask + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Element count, only an approximation under concurrent access
+         */
+        [[nodiscard]] size_t sizeApprox() const
+        {
+            const auto enqueued = this->enqueuePos.load(std::memory_order_relaxed);
+            const auto dequeued = this->dequeuePos.load(std::memory_order_relaxed);
+            return enqueued > dequeued ? enqueued - dequeued : 0uz;
+        }
+
+    private:
+        struct Cell {
+            std::atomic<size_t> sequence{0uz};
+            T data{};
+        };
+
+        const size_t capacity;
+        const size_t mask;
+        const std::unique_ptr<Cell[]> cells;
+        alignas(CacheLineSize) std::atomic<size_t> enqueuePos{0uz};
+        alignas(CacheLineSize) std::atomic<size_t> dequeuePos{0uz};
+    };
+}
+
+#endif
+
+#endif // DYNXX_SRC_CORE_CONCURRENT_LOCK_FREE_QUEUE_HXX_
@@ -0,0 +1,110 @@
+#include "Metrics.hxx"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace
+{
+    using namespace DynXX::Core::Concurrent;
+
+    constexpr size_t bucketIndex(const uint64_t v)
+    {
+        if (v < LatencyHistogram::SubBucketCount)
+        {
+            return static_cast<size_t>(v);
+        }
+        const auto exp = static_cast<size_t>(std::bit_width(v)) - 1uz;
+        const auto shift = exp - LatencyHistogram::SubBucketBits;
+        const auto sub = static_cast<size_t>(v >> shift) & (LatencyHistogram::SubBucketCount - 1uz);
+        return (shift + 1uz) * LatencyHistogram::SubBucketCount + sub;
+    }
+
+    constexpr uint64_t bucketHighestValue(const size_t index)
+    {
+        if (index < LatencyHistogram::SubBucketCount)
+        {
+            return index;
+        }
+        const auto shift = index / LatencyHistogram::SubBucketCount - 1uz;
+        const auto sub = index % LatencyHistogram::SubBucketCount;
+        const auto lowest = static_cast<uint64_t>(LatencyHistogram::SubBucketCount + sub) << shift;
+        return lowest + ((uint64_t{1} << shift) - 1);
+    }
+
+    static_assert(bucketIndex(7) == 7);
+    static_assert(bucketIndex(8) == 8);
+    static_assert(bucketIndex(16) == 16);
+    static_assert(bucketHighestValue(bucketIndex(1000)) >= 1000);
+    static_assert(bucketIndex(UINT64_MAX) < LatencyHistogram::BucketCount);
+}
+
+void DynXX::Core::Concurrent::LatencyHistogram::record(uint64_t microSecs)
+{
+    this->buckets[bucketIndex(microSecs)].fetch_add(1, std::memory_order_relaxed);
+    this->count.fetch_add(1, std::memory_order_relaxed);
+    this->sum.fetch_add(microSecs, std::memory_order_relaxed);
+    auto prevMax = this->max.load(std::memory_order_relaxed);
+    while (microSecs > prevMax && !this->max.compare_exchange_weak(prevMax, microSecs, std::memory_order_relaxed))
+    {
+    }
+}
+
+DynXX::Core::Concurrent::LatencyHistogram::Snapshot DynXX::Core::Concurrent::LatencyHistogram::snapshot() const
+{
+    Snapshot snapshot;
+    for (auto i = 0uz; i < BucketCount; i++)
+    {
+        snapshot.buckets[i] = this->buckets[i].load(std::memory_order_relaxed);
+    }
+    snapshot.count = this->count.load(std::memory_order_relaxed);
+    snapshot.sum = this->sum.load(std::memory_order_relaxed);
+    snapshot.max = this->max.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+double DynXX::Core::Concurrent::LatencyHistogram::Snapshot::mean() const
+{
+    if (this->count == 0)
+    {
+        return 0;
+    }
+    return static_cast<double>(this->sum) / static_cast<double>(this->count);
+}
+
+uint64_t DynXX::Core::Concurrent::LatencyHistogram::Snapshot::valueAt(double percentile) const
+{
+    // Buckets are read one by one while recording, so do not trust `count`
+    auto total = uint64_t{0};
+    for (const auto c : this->buckets)
+    {
+        total += c;
+    }
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    const auto target = std::max(uint64_t{1}, static_cast<uint64_t>(std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * static_cast<double>(total))));
+    auto accumulated = uint64_t{0};
+    for (auto i = 0uz; i < BucketCount; i++)
+    {
+        accumulated += this->buckets[i];
+        if (accumulated >= target)
+        {
+            return std::min(bucketHighestValue(i), this->max);
+        }
+    }
+    return this->max;
+}
+
+void DynXX::Core::Concurrent::LatencyHistogram::Snapshot::merge(const Snapshot &other)
+{
+    for (auto i = 0uz; i < BucketCount; i++)
+    {
+        this->buckets[i] += other.buckets[i];
+    }
+    this->count += other.count;
+    this->sum += other.sum;
+    this->max = std::max(this->max, other.max);
+}
@@ -0,0 +1,67 @@
+#ifndef DYNXX_SRC_CORE_CONCURRENT_METRICS_HXX_
+#define DYNXX_SRC_CORE_CONCURRENT_METRICS_HXX_
+
+#if defined(__cplusplus)
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace DynXX::Core::Concurrent {
+
+    /**
+     * @brief Latency histogram in micro seconds, with HDR-style log-linear buckets.
+     * @note Every power of 2 is split into 8 linear sub-buckets, so values are recorded with a precision of 12.5%.
+     * @note Recording costs a few relaxed atomic adds, no lock is required.
+     */
+    class LatencyHistogram final {
+    public:
+        static constexpr auto SubBucketBits = 3uz;
+        static constexpr auto SubBucketCount = 1uz << SubBucketBits;
+        static constexpr auto BucketCount = (64uz - SubBucketBits + 1uz) * SubBucketCount;
+
+        struct Snapshot {
+            uint64_t count{0};
+            uint64_t sum{0};
+            uint64_t max{0};
+            std::array<uint64_t, BucketCount> buckets{};
+
+            [[nodiscard]] double mean() const;
+
+            /**
+             * @brief Read the value at a percentile
+             * @param percentile Percentile in `[0, 100]`
+             * @return The highest value equivalent to the one at the percentile
+             */
+            [[nodiscard]] uint64_t valueAt(double percentile) const;
+
+            void merge(const Snapshot &other);
+        };
+
+        LatencyHistogram() = default;
+
+        LatencyHistogram(const LatencyHistogram &) = delete;
+
+        LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+        LatencyHistogram(LatencyHistogram &&) = delete;
+
+        LatencyHistogram &operator=(LatencyHistogram &&) = delete;
+
+        ~LatencyHistogram() = default;
+
+        void record(uint64_t microSecs);
+
+        [[nodiscard]] Snapshot snapshot() const;
+
+    private:
+        std::array<std::atomic<uint64_t>, BucketCount> buckets{};
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> sum{0};
+        std::atomic<uint64_t> max{0};
+    };
+}
+
+#endif
+
+#endif // DYNXX_SRC_CORE_CONCURRENT_METRICS_HXX_
@@ -0,0 +1,190 @@
+#ifndef DYNXX_SRC_CORE_CONCURRENT_PARALLEL_HXX_
+#define DYNXX_SRC_CORE_CONCURRENT_PARALLEL_HXX_
+
+#if defined(__cplusplus)
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "Executor.hxx"
+
+namespace DynXX::Core::Concurrent {
+    /// Smallest chunk worth a task hop, in elements, when the grain size is chosen automatically
+    static constexpr auto ParallelMinGrainSize = 16uz * 1024uz;
+
+    /// Chunks per CPU core when the grain size is chosen automatically, to balance uneven chunks
+    static constexpr auto ParallelChunksPerCore = 4uz;
+
+    namespace ParallelDetail {
+        struct State {
+            std::atomic<size_t> nextChunk{0uz};
+            std::atomic<size_t> remainingChunks{0uz};
+            /// Set by the first failed chunk, chunks claimed later are skipped
+            std::atomic_flag failed;
+            /// Written only by the first failed chunk, read by the caller once all chunks are done
+            std::exception_ptr exception{nullptr};
+        };
+
+        /**
+         * @brief Claim & run chunks until none left, return when all claimed chunks are done
+         * @param f Dereferenced only with a claimed chunk, while the caller is still waiting, it may be gone otherwise
+         * @note Exceptions are kept in `state`, a chunk counts as done even if it throws, or the caller would wait forever.
+         */
+        template<typename F>
+        void runChunks(State &state, const size_t chunkCount, F *f)
+        {
+            for (auto chunk = state.nextChunk.fetch_add(1); chunk < chunkCount; chunk = state.nextChunk.fetch_add(1))
+            {
+                if (!state.failed.test()) [[likely]]
+                {
+                    try
+                    {
+                        (*f)(chunk);
+                    }
+                    catch (...)
+                    {
+                        if (!state.failed.test_and_set())
+                        {
+                            state.exception = std::current_exception();
+                        }
+                    }
+                }
+                if (state.remainingChunks.fetch_sub(1) == 1)
+                {
+                    state.remainingChunks.notify_all();
+                }
+            }
+        }
+
+        /**
+         * @brief Run `f(chunkIndex)` for each chunk, on the caller thread and the workers of `executor`
+         * @note The caller runs chunks too, so it is safe to be called on a worker of the same executor.
+         * @throw The first exception thrown by `f`, after all started chunks are done, the chunks not started yet are skipped.
+         */
+        template<typename F>
+        void parallelChunks(Executor &executor, const size_t chunkCount, F &f, const TaskPriority priority)
+        {
+            if (chunkCount == 0) [[unlikely]]
+            {
+                return;
+            }
+            if (chunkCount == 1)
+            {
+                f(0uz);
+                return;
+            }
+
+            // Helpers may start after all chunks are done, so they own the state
+            auto state = std::make_shared<State>();
+            state->remainingChunks.store(chunkCount);
+            const auto helperCount = std::min<size_t>(chunkCount - 1uz, std::max(countCPUCore(), 1u));
+            std::vector<TaskT> helpers;
+            helpers.reserve(helperCount);
+            for (auto i = 0uz; i < helperCount; i++)
+            {
+                helpers.emplace_back([state, chunkCount, pf = &f] {
+                    runChunks(*state, chunkCount, pf);
+                });
+            }
+            executor.submitBatch(helpers, priority);
+
+            runChunks(*state, chunkCount, &f);
+            for (auto remaining = state->remainingChunks.load(); remaining > 0; remaining = state->remainingChunks.load())
+            {
+                state->remainingChunks.wait(remaining);
+            }
+            if (state->exception) [[unlikely]]
+            {
+                std::rethrow_exception(state->exception);
+            }
+        }
+
+        inline size_t grainSizeFor(const size_t count, const size_t grainSize)
+        {
+            if (grainSize > 0)
+            {
+                return grainSize;
+            }
+            const auto chunkCount = std::max(countCPUCore(), 1u) * ParallelChunksPerCore;
+            return std::max(ParallelMinGrainSize, (count + chunkCount - 1uz) / chunkCount);
+        }
+    }
+
+    /**
+     * @brief Run `f(chunkBegin, chunkEnd)` over `[begin, end)` in parallel chunks
+     * @param executor Executor to run chunks, the caller thread runs chunks too
+     * @param begin Begin index
+     * @param end End index (exclusive)
+     * @param f Chunk function, called concurrently with disjoint ranges
+     * @param grainSize Elements per chunk, `0` to choose automatically by the count of CPU cores
+     * @param priority Priority of tasks
+     * @note Small ranges run inline on the caller thread, without any task hop.
+     * @throw The first exception thrown by `f`, once no chunk is running anymore.
+     */
+    template<typename F>
+        requires std::invocable<F &, size_t, size_t>
+    void parallelFor(Executor &executor, const size_t begin, const size_t end, F &&f,
+                     const size_t grainSize = 0uz, const TaskPriority priority = TaskPriority::Normal)
+    {
+        if (end <= begin) [[unlikely]]
+        {
+            return;
+        }
+        const auto count = end - begin;
+        const auto grain = ParallelDetail::grainSizeFor(count, grainSize);
+        const auto chunkCount = (count + grain - 1uz) / grain;
+        auto chunkF = [begin, end, grain, &f](const size_t chunk) {
+            const auto chunkBegin = begin + chunk * grain;
+            f(chunkBegin, std::min(chunkBegin + grain, end));
+        };
+        ParallelDetail::parallelChunks(executor, chunkCount, chunkF, priority);
+    }
+
+    /**
+     * @brief Map chunks of `[begin, end)` in parallel, then reduce the results in order
+     * @param executor Executor to run chunks, the caller thread runs chunks too
+     * @param begin Begin index
+     * @param end End index (exclusive)
+     * @param identity Initial value of the reduction
+     * @param map Chunk function `T(chunkBegin, chunkEnd)`, called concurrently with disjoint ranges
+     * @param reduce Reduce function `T(T, T)`, called on the caller thread in chunk order, so it need not be commutative
+     * @param grainSize Elements per chunk, `0` to choose automatically by the count of CPU cores
+     * @param priority Priority of tasks
+     * @throw The first exception thrown by `map` or `reduce`, once no chunk is running anymore.
+     */
+    template<typename T, typename MapF, typename ReduceF>
+        requires std::invocable<MapF &, size_t, size_t> && std::invocable<ReduceF &, T, T>
+    T parallelReduce(Executor &executor, const size_t begin, const size_t end, T identity, MapF &&map, ReduceF &&reduce,
+                     const size_t grainSize = 0uz, const TaskPriority priority = TaskPriority::Normal)
+    {
+        if (end <= begin) [[unlikely]]
+        {
+            return identity;
+        }
+        const auto count = end - begin;
+        const auto grain = ParallelDetail::grainSizeFor(count, grainSize);
+        const auto chunkCount = (count + grain - 1uz) / grain;
+
+        std::vector<std::optional<T>> results(chunkCount);
+        auto chunkF = [begin, end, grain, &map, &results](const size_t chunk) {
+            const auto chunkBegin = begin + chunk * grain;
+            results[chunk].emplace(map(chunkBegin, std::min(chunkBegin + grain, end)));
+        };
+        ParallelDetail::parallelChunks(executor, chunkCount, chunkF, priority);
+
+        auto acc = std::move(identity);
+        for (auto &result : results)
+        {
+            acc = reduce(std::move(acc), std::move(result.value()));
+        }
+        return acc;
+    }
+}
+
+#endif
+
+#endif // DYNXX_SRC_CORE_CONCURRENT_PARALLEL_HXX_
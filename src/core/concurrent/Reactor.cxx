@@ -0,0 +1,173 @@
+#include "Reactor.hxx"
+#include "ThreadUtil.hxx"
+
+#include <vector>
+
+#include <DynXX/CXX/Log.hxx>
+
+DynXX::Core::Concurrent::Reactor::Reactor(std::string_view name)
+{
+    this->thread = std::thread([this, name = std::string(name)] {
+        this->run(name);
+    });
+}
+
+DynXX::Core::Concurrent::Reactor::~Reactor()
+{
+    this->stop();
+}
+
+void DynXX::Core::Concurrent::Reactor::stop()
+{
+    {
+        auto lock = std::scoped_lock(this->mutex);
+        this->stopped = true;
+    }
+    this->cv.notify_one();
+
+    if (this->thread.joinable())
+    {
+        this->thread.join();
+    }
+
+    // Release outside the lock, tasks may capture resources with their own locks
+    std::deque<TaskT> tasks;
+    std::map<TimerId, Timer> timers;
+    {
+        auto lock = std::scoped_lock(this->mutex);
+        tasks.swap(this->tasks);
+        timers.swap(this->timers);
+        this->dueTimers.clear();
+    }
+}
+
+void DynXX::Core::Concurrent::Reactor::post(TaskT &&task)
+{
+    {
+        auto lock = std::scoped_lock(this->mutex);
+        if (this->stopped) [[unlikely]]
+        {
+            return;
+        }
+        this->tasks.emplace_back(std::move(task));
+    }
+    this->cv.notify_one();
+}
+
+DynXX::Core::Concurrent::Reactor::TimerId DynXX::Core::Concurrent::Reactor::addTimer(size_t delayMicroSecs, size_t intervalMicroSecs, TaskT &&task)
+{
+    TimerId id;
+    {
+        auto lock = std::scoped_lock(this->mutex);
+        if (this->stopped) [[unlikely]]
+        {
+            return 0;
+        }
+        id = this->nextTimerId++;
+        const auto dueTime = TaskClock::now() + std::chrono::microseconds(delayMicroSecs);
+        this->timers.emplace(id, Timer{
+            .dueTime = dueTime,
+            .interval = std::chrono::microseconds(intervalMicroSecs),
+            .task = std::move(task)
+        });
+        this->dueTimers.emplace(dueTime, id);
+    }
+    this->cv.notify_one();
+    return id;
+}
+
+bool DynXX::Core::Concurrent::Reactor::cancelTimer(TimerId id)
+{
+    TaskT task{nullptr};
+    {
+        auto lock = std::scoped_lock(this->mutex);
+        const auto it = this->timers.find(id);
+        if (it == this->timers.end())
+        {
+            return false;
+        }
+        this->dueTimers.erase({it->second.dueTime, id});
+        task = std::move(it->second.task);
+        this->timers.erase(it);
+    }
+    return true;
+}
+
+void DynXX::Core::Concurrent::Reactor::run(const std::string &name)
+{
+    setCurrentThreadName(name);
+
+    auto lock = std::unique_lock(this->mutex);
+    while (!this->stopped)
+    {
+        if (this->tasks.empty())
+        {
+            const auto hasWork = [this] {
+                return this->stopped || !this->tasks.empty() || (!this->dueTimers.empty() && this->dueTimers.begin()->first <= TaskClock::now());
+            };
+            if (this->dueTimers.empty())
+            {
+                this->cv.wait(lock, hasWork);
+            }
+            else
+            {
+                // Woken up by new tasks/timers too, then the earliest due time is read again
+                this->cv.wait_until(lock, this->dueTimers.begin()->first);
+                if (!hasWork())
+                {
+                    continue;
+                }
+            }
+            if (this->stopped)
+            {
+                break;
+            }
+        }
+
+        std::deque<TaskT> readyTasks;
+        readyTasks.swap(this->tasks);
+
+        std::vector<std::pair<TimerId, TaskT>> readyTimers;
+        const auto now = TaskClock::now();
+        while (!this->dueTimers.empty() && this->dueTimers.begin()->first <= now)
+        {
+            const auto id = this->dueTimers.begin()->second;
+            this->dueTimers.erase(this->dueTimers.begin());
+            auto it = this->timers.find(id);
+            readyTimers.emplace_back(id, std::move(it->second.task));
+            if (it->second.interval.count() == 0)
+            {
+                this->timers.erase(it);
+            }
+        }
+
+        lock.unlock();
+        for (auto &task : readyTasks)
+        {
+            task();
+        }
+        for (auto &[id, task] : readyTimers)
+        {
+            task();
+        }
+        readyTasks.clear();
+        lock.lock();
+
+        // Reschedule the repeating timers, unless they were cancelled while running
+        for (auto &[id, task] : readyTimers)
+        {
+            if (auto it = this->timers.find(id); it != this->timers.end() && !it->second.task)
+            {
+                it->second.task = std::move(task);
+                it->second.dueTime = std::max(it->second.dueTime + it->second.interval, TaskClock::now());
+                this->dueTimers.emplace(it->second.dueTime, id);
+            }
+        }
+
+        // Release the one-shot timers outside the lock
+        lock.unlock();
+        readyTimers.clear();
+        lock.lock();
+    }
+    dynxxLogPrintF(DynXXLogLevelX::Debug, "Reactor {} stopped", name);
+}
@@ -0,0 +1,92 @@
+#ifndef DYNXX_SRC_CORE_CONCURRENT_REACTOR_HXX_
+#define DYNXX_SRC_CORE_CONCURRENT_REACTOR_HXX_
+
+#if defined(__cplusplus)
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <set>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "Executor.hxx"
+
+namespace DynXX::Core::Concurrent {
+
+    /**
+     * @brief A single thread running posted tasks and timers.
+     * @note The thread sleeps until a task is posted or the earliest timer is due, it never polls.
+     */
+    class Reactor final {
+    public:
+        using TimerId = uint64_t;
+
+        Reactor() = delete;
+
+        /**
+         * @brief Create a Reactor and start its thread
+         * @param name Thread name
+         */
+        explicit Reactor(std::string_view name);
+
+        Reactor(const Reactor &) = delete;
+
+        Reactor &operator=(const Reactor &) = delete;
+
+        Reactor(Reactor &&) = delete;
+
+        Reactor &operator=(Reactor &&) = delete;
+
+        ~Reactor();
+
+        /**
+         * @brief Run a task on the reactor thread as soon as possible
+         */
+        void post(TaskT &&task);
+
+        /**
+         * @brief Add a timer
+         * @param delayMicroSecs Delay before the first run
+         * @param intervalMicroSecs Interval of the later runs, `0` to run only once
+         * @param task Task to run, on the reactor thread
+         * @return Timer id, to cancel the timer
+         */
+        TimerId addTimer(size_t delayMicroSecs, size_t intervalMicroSecs, TaskT &&task);
+
+        /**
+         * @brief Cancel a timer, the task will be released even if it's running now
+         * @return `false` if the timer was not found (already fired or cancelled)
+         */
+        bool cancelTimer(TimerId id);
+
+        /**
+         * @brief Stop the thread, release pending tasks & timers
+         * @warning Must not be called on the reactor thread.
+         */
+        void stop();
+
+    private:
+        struct Timer {
+            TaskClock::time_point dueTime;
+            TaskClock::duration interval;
+            TaskT task{nullptr};
+        };
+
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool stopped{false};
+        std::deque<TaskT> tasks;
+        std::map<TimerId, Timer> timers;
+        std::set<std::pair<TaskClock::time_point, TimerId>> dueTimers;
+        TimerId nextTimerId{1};
+        std::thread thread;
+
+        void run(const std::string &name);
+    };
+}
+
+#endif
+
+#endif // DYNXX_SRC_CORE_CONCURRENT_REACTOR_HXX_
@@ -0,0 +1,364 @@
+#ifndef DYNXX_SRC_CORE_CONCURRENT_TASK_HXX_
+#define DYNXX_SRC_CORE_CONCURRENT_TASK_HXX_
+
+#if defined(__cplusplus)
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "Executor.hxx"
+#include "Future.hxx"
+
+namespace DynXX::Core::Concurrent {
+    template<typename T>
+    class Task;
+
+    namespace TaskDetail {
+        struct PromiseBase {
+            std::coroutine_handle<> continuation{std::noop_coroutine()};
+            std::exception_ptr exception{nullptr};
+
+            struct FinalAwaiter {
+                [[nodiscard]] bool await_ready() const noexcept
+                {
+                    return false;
+                }
+
+                /// Resume the awaiting coroutine directly, without growing the stack
+                template<typename P>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept
+                {
+                    return h.promise().continuation;
+                }
+
+                void await_resume() const noexcept
+                {
+                }
+            };
+
+            std::suspend_always initial_suspend() const noexcept
+            {
+                return {};
+            }
+
+            FinalAwaiter final_suspend() const noexcept
+            {
+                return {};
+            }
+
+            void unhandled_exception()
+            {
+                this->exception = std::current_exception();
+            }
+
+            void rethrowIfNeeded() const
+            {
+                if (this->exception) [[unlikely]]
+                {
+                    std::rethrow_exception(this->exception);
+                }
+            }
+        };
+
+        template<typename T>
+        struct Promise : PromiseBase {
+            std::optional<T> value;
+
+            template<typename U>
+            void return_value(U &&v)
+            {
+                this->value.emplace(std::forward<U>(v));
+            }
+
+            T result()
+            {
+                this->rethrowIfNeeded();
+                return std::move(this->value.value());
+            }
+        };
+
+        template<>
+        struct Promise<void> : PromiseBase {
+            void return_void() const noexcept
+            {
+            }
+
+            void result() const
+            {
+                this->rethrowIfNeeded();
+            }
+        };
+
+        /// Fire-and-forget coroutine, frees itself when finished
+        struct Detached {
+            struct promise_type {
+                Detached get_return_object() const noexcept
+                {
+                    return {};
+                }
+
+                std::suspend_never initial_suspend() const noexcept
+                {
+                    return {};
+                }
+
+                std::suspend_never final_suspend() const noexcept
+                {
+                    return {};
+                }
+
+                void return_void() const noexcept
+                {
+                }
+
+                void unhandled_exception() const noexcept
+                {
+                    std::terminate();
+                }
+            };
+        };
+    }
+
+    /**
+     * @brief Lazy coroutine task, starts when awaited or spawned.
+     * @note The awaiting coroutine is resumed on the thread finishing this task, usually an Executor worker,
+     * so chains of awaits occupy no thread while waiting.
+     */
+    template<typename T = void>
+    class [[nodiscard]] Task final {
+    public:
+        struct promise_type : TaskDetail::Promise<T> {
+            Task get_return_object() noexcept
+            {
+                return Task{std::coroutine_handle<promise_type>::from_promise(*this)};
+            }
+        };
+
+        Task() = delete;
+
+        Task(const Task &) = delete;
+
+        Task &operator=(const Task &) = delete;
+
+        Task(Task &&other) noexcept : handle{std::exchange(other.handle, nullptr)} {}
+
+        Task &operator=(Task &&other) noexcept
+        {
+            if (this != &other)
+            {
+                this->release();
+                this->handle = std::exchange(other.handle, nullptr);
+            }
+            return *this;
+        }
+
+        ~Task()
+        {
+            this->release();
+        }
+
+        [[nodiscard]] bool await_ready() const noexcept
+        {
+            return !this->handle || this->handle.done();
+        }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+        {
+            this->handle.promise().continuation = awaiting;
+            return this->handle;
+        }
+
+        T await_resume()
+        {
+            return this->handle.promise().result();
+        }
+
+    private:
+        std::coroutine_handle<promise_type> handle{nullptr};
+
+        explicit Task(std::coroutine_handle<promise_type> h) : handle{h} {}
+
+        void release()
+        {
+            if (this->handle)
+            {
+                this->handle.destroy();
+                this->handle = nullptr;
+            }
+        }
+    };
+
+    /**
+     * @brief Awaiter to resume the current coroutine on an Executor worker
+     */
+    class ScheduleAwaiter final {
+    public:
+        explicit ScheduleAwaiter(Executor &executor, TaskPriority priority) : executor{executor}, priority{priority} {}
+
+        [[nodiscard]] bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> h) const
+        {
+            this->executor >> Job{
+                .task = [h] { h.resume(); },
+                .priority = this->priority
+            };
+        }
+
+        void await_resume() const noexcept
+        {
+        }
+
+    private:
+        Executor &executor;
+        TaskPriority priority;
+    };
+
+    /**
+     * @brief Awaiter of a Future, resumes the coroutine on the thread fulfilling the Future
+     */
+    template<typename T>
+    class FutureAwaiter final {
+    public:
+        explicit FutureAwaiter(Future<T> &&future) : future{std::move(future)} {}
+
+        [[nodiscard]] bool await_ready() const
+        {
+            return this->future.ready();
+        }
+
+        /// Suspend only if the continuation is stored, otherwise it could resume the coroutine while still in here
+        bool await_suspend(std::coroutine_handle<> h)
+        {
+            return this->future.whenReady([h] {
+                h.resume();
+            });
+        }
+
+        T await_resume()
+        {
+            if constexpr (std::is_void_v<T>)
+            {
+                this->future.get();
+            }
+            else
+            {
+                return this->future.get();
+            }
+        }
+
+    private:
+        Future<T> future;
+    };
+
+    template<typename T>
+    FutureAwaiter<T> operator co_await(Future<T> &&future)
+    {
+        return FutureAwaiter<T>{std::move(future)};
+    }
+
+    /**
+     * @brief Resume the current coroutine on a worker of `executor`
+     * @param executor The Executor
+     * @param priority Task priority
+     */
+    inline ScheduleAwaiter schedule(Executor &executor, TaskPriority priority = TaskPriority::Normal)
+    {
+        return ScheduleAwaiter{executor, priority};
+    }
+
+    /**
+     * @brief Run a blocking function on `executor` and await its result
+     * @param executor The Executor
+     * @param f The blocking function
+     * @param priority Task priority
+     */
+    template<typename F, typename R = std::invoke_result_t<F>>
+    Task<R> async(Executor &executor, F f, TaskPriority priority = TaskPriority::Normal)
+    {
+        co_return co_await executor.submit(std::move(f), priority);
+    }
+
+    /**
+     * @brief Run a blocking function on `Executor::blockingIO()` and await its result back on `executor`
+     * @param executor The Executor to resume on
+     * @param f The blocking function, e.g. a network request or a file access
+     * @param priority Priority of the resumption on `executor`
+     * @note No worker of `executor` is held while `f` runs, only a blocking I/O worker.
+     */
+    template<typename F, typename R = std::invoke_result_t<F>>
+    Task<R> blockingAsync(Executor &executor, F f, TaskPriority priority = TaskPriority::Normal)
+    {
+        std::exception_ptr exception{nullptr};
+        std::optional<std::conditional_t<std::is_void_v<R>, std::monostate, R>> result;
+        try
+        {
+            if constexpr (std::is_void_v<R>)
+            {
+                co_await Executor::blockingIO().submit(std::move(f));
+                result.emplace();
+            }
+            else
+            {
+                result.emplace(co_await Executor::blockingIO().submit(std::move(f)));
+            }
+        }
+        catch (...)
+        {
+            exception = std::current_exception();
+        }
+
+        // Leave the blocking I/O worker, it fulfilled the Future and resumed here
+        co_await schedule(executor, priority);
+        if (exception) [[unlikely]]
+        {
+            std::rethrow_exception(exception);
+        }
+        if constexpr (!std::is_void_v<R>)
+        {
+            co_return std::move(result.value());
+        }
+    }
+
+    /**
+     * @brief Start a Task without awaiting it
+     * @param task The Task, runs inline on the caller thread until its first suspension
+     * @return Future of the task result
+     */
+    template<typename T>
+    Future<T> spawn(Task<T> &&task)
+    {
+        Promise<T> promise;
+        auto future = promise.future();
+        [](Task<T> t, Promise<T> p) -> TaskDetail::Detached {
+            try
+            {
+                if constexpr (std::is_void_v<T>)
+                {
+                    co_await std::move(t);
+                    p.set();
+                }
+                else
+                {
+                    p.set(co_await std::move(t));
+                }
+            }
+            catch (...)
+            {
+                p.setException(std::current_exception());
+            }
+        }(std::move(task), std::move(promise));
+        return future;
+    }
+}
+
+#endif
+
+#endif // DYNXX_SRC_CORE_CONCURRENT_TASK_HXX_
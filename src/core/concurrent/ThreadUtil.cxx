@@ -0,0 +1,161 @@
+#include "ThreadUtil.hxx"
+
+#include <cstdlib>
+#include <string>
+
+#if defined(__linux__) || defined(__ANDROID__) || defined(__OHOS__)
+#include <fstream>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#define DYNXX_THREAD_LINUX
+#elif defined(__APPLE__)
+#include <pthread.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+
+#include <DynXX/CXX/Log.hxx>
+
+namespace
+{
+#if defined(DYNXX_THREAD_LINUX)
+    constexpr auto MaxThreadNameLength = 15uz;
+    constexpr auto NumaNodePath = "/sys/devices/system/node/node";
+
+    /// Parse a Linux CPU list like `0-3,8-11`
+    bool parseCPUList(const std::string &list, cpu_set_t &set)
+    {
+        CPU_ZERO(&set);
+        auto count = 0uz;
+        size_t pos = 0;
+        while (pos < list.size())
+        {
+            auto end = list.find(',', pos);
+            if (end == std::string::npos)
+            {
+                end = list.size();
+            }
+            const auto range = list.substr(pos, end - pos);
+            pos = end + 1;
+            if (range.empty())
+            {
+                continue;
+            }
+
+            char *rangeEnd = nullptr;
+            const auto first = std::strtoul(range.c_str(), &rangeEnd, 10);
+            auto last = first;
+            if (rangeEnd != nullptr && *rangeEnd == '-')
+            {
+                last = std::strtoul(rangeEnd + 1, nullptr, 10);
+            }
+            for (auto cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++)
+            {
+                CPU_SET(cpu, &set);
+                count++;
+            }
+        }
+        return count > 0;
+    }
+
+    bool readNumaNodeCPUs(const size_t node, cpu_set_t &set)
+    {
+        std::ifstream ifs(std::string(NumaNodePath) + std::to_string(node) + "/cpulist");
+        if (!ifs.is_open())
+        {
+            return false;
+        }
+        std::string list;
+        std::getline(ifs, list);
+        return parseCPUList(list, set);
+    }
+
+    bool setCurrentThreadAffinity(const cpu_set_t &set)
+    {
+        return sched_setaffinity(0, sizeof(cpu_set_t), &set) == 0;
+    }
+#endif
+}
+
+void DynXX::Core::Concurrent::setCurrentThreadName(std::string_view name)
+{
+#if defined(DYNXX_THREAD_LINUX)
+    const std::string s(name.substr(0, MaxThreadNameLength));
+    pthread_setname_np(pthread_self(), s.c_str());
+#elif defined(__APPLE__)
+    const std::string s(name);
+    pthread_setname_np(s.c_str());
+#elif defined(_WIN32)
+    const std::wstring ws(name.begin(), name.end());
+    SetThreadDescription(GetCurrentThread(), ws.c_str());
+#else
+    (void)name;
+#endif
+}
+
+size_t DynXX::Core::Concurrent::countNumaNode()
+{
+#if defined(DYNXX_THREAD_LINUX)
+    static const auto count = [] {
+        auto n = 0uz;
+        while (std::ifstream(std::string(NumaNodePath) + std::to_string(n) + "/cpulist").is_open())
+        {
+            n++;
+        }
+        return n > 0 ? n : 1uz;
+    }();
+    return count;
+#else
+    return 1uz;
+#endif
+}
+
+bool DynXX::Core::Concurrent::pinCurrentThreadToCore(size_t core)
+{
+#if defined(DYNXX_THREAD_LINUX)
+    if (core >= CPU_SETSIZE) [[unlikely]]
+    {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    if (!setCurrentThreadAffinity(set))
+    {
+        dynxxLogPrintF(DynXXLogLevelX::Warn, "pin thread to core {} failed", core);
+        return false;
+    }
+    return true;
+#elif defined(_WIN32)
+    if (core >= sizeof(DWORD_PTR) * 8) [[unlikely]]
+    {
+        return false;
+    }
+    return SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << core) != 0;
+#else
+    (void)core;
+    return false;
+#endif
+}
+
+bool DynXX::Core::Concurrent::pinCurrentThreadToNumaNode(size_t node)
+{
+#if defined(DYNXX_THREAD_LINUX)
+    cpu_set_t set;
+    if (!readNumaNodeCPUs(node, set))
+    {
+        dynxxLogPrintF(DynXXLogLevelX::Warn, "read CPUs of NUMA node {} failed", node);
+        return false;
+    }
+    if (!setCurrentThreadAffinity(set))
+    {
+        dynxxLogPrintF(DynXXLogLevelX::Warn, "pin thread to NUMA node {} failed", node);
+        return false;
+    }
+    return true;
+#else
+    (void)node;
+    return false;
+#endif
+}
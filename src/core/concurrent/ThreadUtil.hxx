@@ -0,0 +1,40 @@
+#ifndef DYNXX_SRC_CORE_CONCURRENT_THREAD_UTIL_HXX_
+#define DYNXX_SRC_CORE_CONCURRENT_THREAD_UTIL_HXX_
+
+#if defined(__cplusplus)
+
+#include <cstddef>
+#include <string_view>
+
+namespace DynXX::Core::Concurrent {
+
+    /**
+     * @brief Name the current thread, shown in debuggers & perf traces
+     * @param name Thread name, truncated to 15 chars on Linux/Android
+     */
+    void setCurrentThreadName(std::string_view name);
+
+    /**
+     * @brief Count NUMA nodes
+     * @return NUMA node count, `1` if unknown or not supported
+     */
+    size_t countNumaNode();
+
+    /**
+     * @brief Pin the current thread to a CPU core
+     * @param core Index of the CPU core
+     * @return Successful or not, always fails on platforms not supporting affinity (e.g. Apple)
+     */
+    bool pinCurrentThreadToCore(size_t core);
+
+    /**
+     * @brief Pin the current thread to all the CPU cores of a NUMA node
+     * @param node Index of the NUMA node
+     * @return Successful or not, always fails on platforms without NUMA info
+     */
+    bool pinCurrentThreadToNumaNode(size_t node);
+}
+
+#endif
+
+#endif // DYNXX_SRC_CORE_CONCURRENT_THREAD_UTIL_HXX_
@@ -262,6 +262,18 @@ DynXXHttpResponse DynXX::Core::Net::HttpClient::request(std::string_view url, in
     return rsp;
 }
 
+DynXX::Core::Concurrent::Task<DynXXHttpResponse> DynXX::Core::Net::HttpClient::requestAsync(Concurrent::Executor &executor,
+                                                                                            std::string url, int method,
+                                                                                            std::vector<std::string> headers,
+                                                                                            std::string params,
+                                                                                            Bytes rawBody,
+                                                                                            std::vector<HttpFormField> formFields,
+                                                                                            size_t timeout) const {
+    co_return co_await Concurrent::blockingAsync(executor, [&, this] {
+        return this->request(url, method, headers, params, rawBody, formFields, nullptr, 0, timeout);
+    });
+}
+
 bool DynXX::Core::Net::HttpClient::download(std::string_view url, const std::string_view filePath, size_t timeout) const {
     auto curl = createReq(url, {}, {}, DynXXNetHttpMethodGet, timeout);
     if (!curl) [[unlikely]]
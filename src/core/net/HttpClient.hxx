@@ -8,6 +8,8 @@
 #include <DynXX/CXX/Types.hxx>
 #include <DynXX/CXX/Net.hxx>
 
+#include "../concurrent/Task.hxx"
+
 namespace DynXX::Core::Net {
     struct HttpFormField {
         std::string name;
@@ -37,6 +39,19 @@ namespace DynXX::Core::Net {
                                                  const std::FILE *cFILE, size_t fileSize,
                                                  size_t timeout) const;
 
+        /**
+         * @brief Awaitable version of `request()`, resumes on a worker of `executor` with the response
+         * @note The request blocks a worker of `Executor::blockingIO()`, not of `executor`.
+         * Arguments are owned by the coroutine, so they stay valid until the request finishes.
+         */
+        [[nodiscard]] Concurrent::Task<DynXXHttpResponse> requestAsync(Concurrent::Executor &executor,
+                                                                       std::string url, int method,
+                                                                       std::vector<std::string> headers,
+                                                                       std::string params,
+                                                                       Bytes rawBody,
+                                                                       std::vector<HttpFormField> formFields,
+                                                                       size_t timeout) const;
+
         [[nodiscard]] bool download(std::string_view url, const std::string_view filePath, size_t timeout) const;
 
         ~HttpClient();
@@ -97,6 +97,13 @@ std::unique_ptr<DynXX::Core::Store::SQLite::Connection::QueryResult> DynXX::Core
     return std::make_unique<DynXX::Core::Store::SQLite::Connection::QueryResult>(stmt);
 }
 
+DynXX::Core::Concurrent::Task<std::unique_ptr<DynXX::Core::Store::SQLite::Connection::QueryResult>> DynXX::Core::Store::SQLite::Connection::queryAsync(Concurrent::Executor &executor, std::string sql) const
+{
+    co_return co_await Concurrent::blockingAsync(executor, [&sql, this] {
+        return this->query(sql);
+    });
+}
+
 DynXX::Core::Store::SQLite::Connection::~Connection()
 {
     if (this->db != nullptr) [[likely]]
@@ -8,6 +8,7 @@
 #include <DynXX/CXX/Types.hxx>
 
 #include "ConnPool.hxx"
+#include "../concurrent/Task.hxx"
 
 namespace DynXX::Core::Store::SQLite {
 
@@ -84,6 +85,15 @@ namespace DynXX::Core::Store::SQLite {
              */
             std::unique_ptr<QueryResult> query(std::string_view sql) const;
 
+            /**
+             * @brief Awaitable version of `query()`, the SQL is prepared on a worker of `Executor::blockingIO()`
+             * @param executor Executor to resume on with the result
+             * @param sql SQL
+             * @return A QueryResult, or `nullptr` if execute failed.
+             * @warning The Connection must outlive the returned Task.
+             */
+            Concurrent::Task<std::unique_ptr<QueryResult>> queryAsync(Concurrent::Executor &executor, std::string sql) const;
+
             /**
              * @brief Release DB resource
              */
@@ -2,12 +2,57 @@
 
 #include "BaseVM.hxx"
 
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <thread>
+#include <vector>
+
 #include <DynXX/CXX/Log.hxx>
 #include "../concurrent/ConcurrentUtil.hxx"
 
 namespace
 {
     constexpr auto SleepMicroSecs = 1000uz;
+    /// Per VM kind & version, evicted down to 3/4 of it once exceeded
+    constexpr auto MaxCodeCacheBytes = 16uz * 1024uz * 1024uz;
+
+    void _evictCodeCache(const std::filesystem::path &dir)
+    {
+        std::error_code ec;
+        std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::directory_entry>> files;
+        auto totalBytes = 0uz;
+        for (const auto &entry : std::filesystem::directory_iterator(dir, ec))
+        {
+            if (!entry.is_regular_file(ec))
+            {
+                continue;
+            }
+            totalBytes += entry.file_size(ec);
+            files.emplace_back(entry.last_write_time(ec), entry);
+        }
+        if (totalBytes <= MaxCodeCacheBytes)
+        {
+            return;
+        }
+        std::ranges::sort(files, {}, [](const auto &file) { return file.first; });
+        for (const auto &[time, entry] : files)
+        {
+            if (totalBytes <= MaxCodeCacheBytes / 4 * 3)
+            {
+                break;
+            }
+            const auto size = entry.file_size(ec);
+            if (std::filesystem::remove(entry.path(), ec))
+            {
+                totalBytes -= size;
+            }
+        }
+    }
 }
 
 bool DynXX::Core::VM::BaseVM::tryLock()
@@ -20,9 +65,107 @@ void DynXX::Core::VM::BaseVM::unlock()
     this->vmMutex.unlock();
 }
 
-void DynXX::Core::VM::BaseVM::sleep() const
+void DynXX::Core::VM::BaseVM::submit(Concurrent::Job &&job)
+{
+    const auto done = [jobCount = this->jobCount] {
+        if (jobCount->fetch_sub(1) == 1)
+        {
+            jobCount->notify_all();
+        }
+    };
+
+    this->jobCount->fetch_add(1);
+    Concurrent::Executor::shared() >> Concurrent::Job{
+        .task = [task = std::move(job.task), done]() mutable {
+            task();
+            done();
+        },
+        .priority = job.priority,
+        .deadline = job.deadline,
+        .onExpired = [onExpired = std::move(job.onExpired), done]() mutable {
+            if (onExpired)
+            {
+                onExpired();
+            }
+            done();
+        }
+    };
+}
+
+void DynXX::Core::VM::BaseVM::waitForJobs()
+{
+    for (auto count = this->jobCount->load(); count > 0; count = this->jobCount->load())
+    {
+        this->jobCount->wait(count);
+    }
+}
+
+std::string DynXX::Core::VM::BaseVM::prepareCodeCacheDir(const std::string &root, std::string_view kind, std::string_view version)
+{
+    if (root.empty())
+    {
+        return {};
+    }
+    std::string versionName(version);
+    std::ranges::replace_if(versionName, [](const char c) { return !std::isalnum(static_cast<unsigned char>(c)) && c != '.' && c != '-'; }, '_');
+
+    std::error_code ec;
+    const auto kindDir = std::filesystem::path(root) / "code-cache" / kind;
+    // Caches of other versions can never be read again
+    for (const auto &entry : std::filesystem::directory_iterator(kindDir, ec))
+    {
+        if (entry.path().filename() != versionName)
+        {
+            std::filesystem::remove_all(entry.path(), ec);
+        }
+    }
+    const auto dir = kindDir / versionName;
+    std::filesystem::create_directories(dir, ec);
+    if (ec) [[unlikely]]
+    {
+        dynxxLogPrintF(DynXXLogLevelX::Warn, "VM code cache disabled, can not create: {}", dir.string());
+        return {};
+    }
+    return dir.string();
+}
+
+Bytes DynXX::Core::VM::BaseVM::readCodeCache(const std::string &path)
+{
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs.is_open())
+    {
+        return {};
+    }
+    Bytes bytes{std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>()};
+    std::error_code ec;
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+    return bytes;
+}
+
+void DynXX::Core::VM::BaseVM::writeCodeCache(const std::string &path, BytesView bytes)
 {
-    DynXX::Core::Concurrent::sleep(SleepMicroSecs);
+    const auto tmpPath = path + "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+    {
+        std::ofstream ofs(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!ofs.is_open()) [[unlikely]]
+        {
+            dynxxLogPrintF(DynXXLogLevelX::Warn, "VM code cache write failed: {}", path);
+            return;
+        }
+        ofs.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!ofs.good()) [[unlikely]]
+        {
+            ofs.close();
+            std::remove(tmpPath.c_str());
+            return;
+        }
+    }
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) [[unlikely]]
+    {
+        std::remove(tmpPath.c_str());
+        return;
+    }
+    _evictCodeCache(std::filesystem::path(path).parent_path());
 }
 
 DynXX::Core::VM::BaseVM::BaseVM() : active(true)
@@ -4,6 +4,10 @@
 #if defined(__cplusplus)
 
 #include <atomic>
+#include <memory>
+#include <string>
+
+#include <DynXX/CXX/Types.hxx>
 
 #include "../concurrent/Executor.hxx"
 
@@ -25,13 +29,42 @@ namespace DynXX::Core::VM {
     protected:
         std::atomic<bool> active{false};
         std::recursive_timed_mutex vmMutex;
-        Concurrent::Executor executor;
 
         [[nodiscard]] bool tryLock();
 
         void unlock();
 
-        void sleep() const;
+        /**
+         * @brief Submit a job to the process-wide shared Executor, tracked until it finishes
+         */
+        void submit(Concurrent::Job &&job);
+
+        /**
+         * @brief Wait for all submitted jobs to finish, call it before releasing resources used by them
+         */
+        void waitForJobs();
+
+        /**
+         * @brief Prepare the compiled code cache dir `<root>/code-cache/<kind>/<version>`, removing the caches of other versions
+         * @return The dir, empty if `root` is empty or the dir can not be created, which disables the cache
+         */
+        static std::string prepareCodeCacheDir(const std::string &root, std::string_view kind, std::string_view version);
+
+        /**
+         * @brief Read a compiled code cache file, and mark it as recently used
+         * @return Empty if not cached
+         */
+        static Bytes readCodeCache(const std::string &path);
+
+        /**
+         * @brief Write a compiled code cache file, through a temp file so that other VMs never read a partial one
+         * @note The least recently used files in the same dir are evicted beyond `MaxCodeCacheBytes`.
+         */
+        static void writeCodeCache(const std::string &path, BytesView bytes);
+
+    private:
+        /// Shared with the submitted jobs, which may still notify it after `waitForJobs` returned
+        std::shared_ptr<std::atomic<size_t>> jobCount{std::make_shared<std::atomic<size_t>>(0uz)};
     };
 }
 
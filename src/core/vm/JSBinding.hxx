@@ -0,0 +1,238 @@
+#ifndef DYNXX_SRC_CORE_VM_JSBINDING_HXX_
+#define DYNXX_SRC_CORE_VM_JSBINDING_HXX_
+
+#if defined(__cplusplus)
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "JSVM.hxx"
+
+/**
+ * Native-typed bindings: JS arguments are converted straight to the C++ parameter types of `fX`,
+ * and the result straight to a JS value, without any JSON in between.
+ */
+#define DEF_JS_FUNC_TYPED(fJ, fX)                                              \
+  static JSValue fJ(JS_FUNC_PARAMS) {                                          \
+    return DynXX::Core::VM::JSBinding::call(fX, ctx, argc, argv);              \
+  }
+
+#define BIND_JS_FUNC_TYPED(name, fJ, fX)                                       \
+  JS_CFUNC_DEF(name, DynXX::Core::VM::JSBinding::arity(fX), fJ)
+
+namespace DynXX::Core::VM::JSBinding {
+
+    /// Owned argument type: string views are backed by a `std::string` for the duration of the call
+    template<typename T>
+    using ArgT = std::conditional_t<std::is_same_v<std::remove_cvref_t<T>, std::string_view>,
+        std::string, std::remove_cvref_t<T>>;
+
+    template<typename T>
+    constexpr bool IsBytesView = std::is_same_v<T, BytesView>;
+
+    template<typename T>
+    struct IsOptional : std::false_type {
+    };
+
+    template<typename T>
+    struct IsOptional<std::optional<T>> : std::true_type {
+    };
+
+    template<typename R, typename... Args>
+    consteval uint8_t arity(R (*)(Args...))
+    {
+        return static_cast<uint8_t>(sizeof...(Args));
+    }
+
+    /**
+     * @brief Convert a JS value to a C++ argument
+     * @return `false` with a pending JS exception if failed
+     * @note Handles (`void *`) are the address strings returned to JS, numbers are accepted too.
+     */
+    template<typename T>
+    bool fromJS(JSContext *ctx, JSValueConst jVal, T &v)
+    {
+        if constexpr (std::is_same_v<T, bool>)
+        {
+            const auto b = JS_ToBool(ctx, jVal);
+            if (b < 0) [[unlikely]]
+            {
+                return false;
+            }
+            v = b != 0;
+        }
+        else if constexpr (std::is_enum_v<T>)
+        {
+            int32_t i;
+            if (JS_ToInt32(ctx, &i, jVal) < 0) [[unlikely]]
+            {
+                return false;
+            }
+            v = static_cast<T>(i);
+        }
+        else if constexpr (std::is_integral_v<T>)
+        {
+            int64_t i;
+            if (JS_ToInt64(ctx, &i, jVal) < 0) [[unlikely]]
+            {
+                return false;
+            }
+            v = static_cast<T>(i);
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            double d;
+            if (JS_ToFloat64(ctx, &d, jVal) < 0) [[unlikely]]
+            {
+                return false;
+            }
+            v = static_cast<T>(d);
+        }
+        else if constexpr (std::is_same_v<T, std::string>)
+        {
+            size_t len;
+            const auto s = JS_ToCStringLen(ctx, &len, jVal);
+            if (s == nullptr) [[unlikely]]
+            {
+                return false;
+            }
+            v.assign(s, len);
+            JS_FreeCString(ctx, s);
+        }
+        else if constexpr (std::is_same_v<T, BytesView>)
+        {
+            // Valid until JS runs again, which may detach or resize the buffer; see `call`
+            v = JSVM::toBytesView(ctx, jVal);
+        }
+        else if constexpr (std::is_same_v<T, Bytes>)
+        {
+            const auto view = JSVM::toBytesView(ctx, jVal);
+            v.assign(view.begin(), view.end());
+        }
+        else if constexpr (std::is_pointer_v<T>)
+        {
+            int64_t addr = 0;
+            if (JS_IsString(jVal))
+            {
+                std::string s;
+                if (!fromJS(ctx, jVal, s)) [[unlikely]]
+                {
+                    return false;
+                }
+                addr = str2int64(s, 0);
+            }
+            else if (!JS_IsUndefined(jVal) && JS_ToInt64(ctx, &addr, jVal) < 0) [[unlikely]]
+            {
+                return false;
+            }
+            v = addr2ptr<std::remove_pointer_t<T>>(addr);
+        }
+        else
+        {
+            static_assert(sizeof(T) == 0, "Unsupported JS argument type");
+        }
+        return true;
+    }
+
+    /**
+     * @brief Convert a C++ result to a JS value
+     * @note `std::nullopt` is `undefined`, handles are address strings (empty for `nullptr`) as the JSON bindings return.
+     */
+    template<typename T>
+    JSValue toJS(JSContext *ctx, T &&v)
+    {
+        using U = std::remove_cvref_t<T>;
+        if constexpr (IsOptional<U>::value)
+        {
+            if (!v.has_value())
+            {
+                return JS_UNDEFINED;
+            }
+            return toJS(ctx, std::move(v.value()));
+        }
+        else if constexpr (std::is_same_v<U, bool>)
+        {
+            return JS_NewBool(ctx, v);
+        }
+        else if constexpr (std::is_enum_v<U>)
+        {
+            return JS_NewInt32(ctx, static_cast<int32_t>(v));
+        }
+        else if constexpr (std::is_integral_v<U>)
+        {
+            return JS_NewInt64(ctx, static_cast<int64_t>(v));
+        }
+        else if constexpr (std::is_floating_point_v<U>)
+        {
+            return JS_NewFloat64(ctx, static_cast<double>(v));
+        }
+        else if constexpr (std::is_same_v<U, std::string>)
+        {
+            return JS_NewStringLen(ctx, v.data(), v.size());
+        }
+        else if constexpr (std::is_same_v<U, Bytes>)
+        {
+            return JSVM::newArrayBuffer(ctx, Bytes(std::forward<T>(v)));
+        }
+        else if constexpr (std::is_same_v<U, std::vector<std::string>>)
+        {
+            auto jArr = JS_NewArray(ctx);
+            for (auto i = 0uz; i < v.size(); i++)
+            {
+                JS_SetPropertyUint32(ctx, jArr, static_cast<uint32_t>(i), JS_NewStringLen(ctx, v[i].data(), v[i].size()));
+            }
+            return jArr;
+        }
+        else if constexpr (std::is_pointer_v<U>)
+        {
+            if (v == nullptr)
+            {
+                return JS_NewStringLen(ctx, "", 0);
+            }
+            const auto s = std::to_string(ptr2addr(v));
+            return JS_NewStringLen(ctx, s.data(), s.size());
+        }
+        else
+        {
+            static_assert(sizeof(U) == 0, "Unsupported JS result type");
+        }
+    }
+
+    /**
+     * @brief Call `f` with the JS arguments converted to its parameter types
+     * @return The converted result, or `JS_EXCEPTION` if arguments are missing or can not be converted
+     * @note `BytesView` arguments are converted last, since converting the others may run JS (`toString()`, `valueOf()`),
+     * and `f` must not run JS either.
+     */
+    template<typename R, typename... Args>
+    JSValue call(R (*f)(Args...), JSContext *ctx, const int argc, JSValueConst *argv)
+    {
+        if (argc < static_cast<int>(sizeof...(Args))) [[unlikely]]
+        {
+            return JS_ThrowTypeError(ctx, "expecting %zu arguments, got %d", sizeof...(Args), argc);
+        }
+        std::tuple<ArgT<Args>...> args;
+        const auto converted = [&]<size_t... I>(std::index_sequence<I...>) {
+            return ((IsBytesView<ArgT<Args>> || fromJS(ctx, argv[I], std::get<I>(args))) && ...)
+                && ((!IsBytesView<ArgT<Args>> || fromJS(ctx, argv[I], std::get<I>(args))) && ...);
+        }(std::index_sequence_for<Args...>{});
+        if (!converted) [[unlikely]]
+        {
+            return JS_EXCEPTION;
+        }
+        if constexpr (std::is_void_v<R>)
+        {
+            std::apply(f, std::move(args));
+            return JS_UNDEFINED;
+        }
+        else
+        {
+            return toJS(ctx, std::apply(f, std::move(args)));
+        }
+    }
+}
+
+#endif
+
+#endif // DYNXX_SRC_CORE_VM_JSBINDING_HXX_
@@ -1,14 +1,69 @@
 #if defined(USE_QJS)
 #include "JSVM.hxx"
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <thread>
 #include <utility>
 
 #include <DynXX/CXX/Log.hxx>
 
+#include "../coding/Coding.hxx"
+#include "../crypto/Crypto.hxx"
+
 namespace
 {
+    constexpr auto AwaitRecheckMicroSecs = 10'000uz;
+    constexpr auto MinTimerIntervalMicroSecs = 1'000uz;
+
+    int64_t _steadyNanoSecs(const std::chrono::steady_clock::time_point t)
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+    }
+
+    /// Set the interrupt deadline while the VM is locked, a nested call keeps the earlier deadline of the outer one
+    class _DeadlineScope final
+    {
+    public:
+        _DeadlineScope(std::atomic<int64_t> &deadline, const std::chrono::steady_clock::time_point t) :
+            deadline(deadline), lastDeadline(deadline.load())
+        {
+            if (t == std::chrono::steady_clock::time_point::max())
+            {
+                return;
+            }
+            if (const auto ns = _steadyNanoSecs(t); this->lastDeadline == 0 || ns < this->lastDeadline)
+            {
+                this->deadline = ns;
+            }
+        }
+
+        _DeadlineScope(const _DeadlineScope &) = delete;
+
+        _DeadlineScope &operator=(const _DeadlineScope &) = delete;
+
+        ~_DeadlineScope()
+        {
+            this->deadline = this->lastDeadline;
+        }
+
+    private:
+        std::atomic<int64_t> &deadline;
+        const int64_t lastDeadline;
+    };
+
+    // Same as the QuickJS defaults, to restore them when the settings are cleared
+    constexpr auto DefaultGCThreshold = 256uz * 1024uz;
+    constexpr auto DefaultMaxStackSize = 1024uz * 1024uz;
+
+    constexpr auto IMPORT_STD_OS_JS_NAME = "import-std-os.js";
     constexpr auto IMPORT_STD_OS_JS = "import * as std from 'qjs:std';\n"
                                          "import * as os from 'qjs:os';\n"
                                          "globalThis.std = std;\n"
@@ -77,6 +132,92 @@ namespace
         return true;
     }
 
+    /// Evaluate a compiled (or read) function or module, it will be freed
+    bool _evalCompiled(JSContext *ctx, const JSValue jObj, const bool isModule, const bool resolve)
+    {
+        if (isModule)
+        {
+            if (JS_VALUE_GET_TAG(jObj) != JS_TAG_MODULE) [[unlikely]]
+            {
+                dynxxLogPrint(DynXXLogLevelX::Error, "JS try to load invalid module");
+                JS_FreeValue(ctx, jObj);
+                return false;
+            }
+            if (resolve && JS_ResolveModule(ctx, jObj) < 0) [[unlikely]]
+            {
+                dynxxLogPrint(DynXXLogLevelX::Error, "JS_ResolveModule failed ->");
+                dumpJsErr(ctx);
+                JS_FreeValue(ctx, jObj);
+                return false;
+            }
+            js_module_set_import_meta(ctx, jObj, false, true);
+        }
+        const auto jRet = JS_EvalFunction(ctx, jObj);
+        if (JS_IsException(jRet)) [[unlikely]]
+        {
+            dynxxLogPrint(DynXXLogLevelX::Error, "JS_EvalFunction failed ->");
+            dumpJsErr(ctx);
+            return false;
+        }
+        JS_FreeValue(ctx, jRet);
+        return true;
+    }
+
+// JSVM bytecode cache
+
+    std::string _bytecodeCachePath(const std::string &dir, const std::string &script, const std::string &name, const bool isModule)
+    {
+        // Bytecode is not compatible between QuickJS versions, and embeds the name for module resolving & stack traces
+        std::string key(JS_GetVersion());
+        key.push_back('\0');
+        key.push_back(isModule ? 'M' : 'G');
+        key.append(name);
+        key.push_back('\0');
+        key.append(script);
+        const auto hash = DynXX::Core::Crypto::Hash::sha256(makeBytesView(reinterpret_cast<const byte *>(key.data()), key.size()));
+        return dir + "/" + DynXX::Core::Coding::Hex::bytes2str(hash) + ".jsc";
+    }
+
+    /// Bytecode of `IMPORT_STD_OS_JS`, compiled once and shared by all the contexts (incl. workers) in the process
+    std::mutex importStdOsMutex;
+    Bytes importStdOsBytecode;
+
+    void _importStdOs(JSContext *ctx)
+    {
+        Bytes bytecode;
+        {
+            auto lock = std::scoped_lock(importStdOsMutex);
+            bytecode = importStdOsBytecode;
+        }
+
+        if (!bytecode.empty()) [[likely]]
+        {
+            if (const auto jObj = JS_ReadObject(ctx, bytecode.data(), bytecode.size(), JS_READ_OBJ_BYTECODE); !JS_IsException(jObj)) [[likely]]
+            {
+                _evalCompiled(ctx, jObj, true, true);
+                return;
+            }
+            JS_FreeValue(ctx, JS_GetException(ctx));
+        }
+
+        const auto jObj = JS_Eval(ctx, IMPORT_STD_OS_JS, std::strlen(IMPORT_STD_OS_JS), IMPORT_STD_OS_JS_NAME,
+                                  JS_EVAL_TYPE_MODULE | JS_EVAL_FLAG_COMPILE_ONLY);
+        if (JS_IsException(jObj)) [[unlikely]]
+        {
+            dynxxLogPrint(DynXXLogLevelX::Error, "JS_Eval failed ->");
+            dumpJsErr(ctx);
+            return;
+        }
+        size_t len = 0;
+        if (const auto buf = JS_WriteObject(ctx, &len, jObj, JS_WRITE_OBJ_BYTECODE)) [[likely]]
+        {
+            auto lock = std::scoped_lock(importStdOsMutex);
+            importStdOsBytecode.assign(buf, buf + len);
+            js_free(ctx, buf);
+        }
+        _evalCompiled(ctx, jObj, true, false);
+    }
+
     /// A JS Worker created a all new independent `JSContext`，so we should load the js files and modules again.
     /// By default, we just load the built-in modules.
     JSContext *_newContext(JSRuntime *rt)
@@ -91,7 +232,7 @@ namespace
         js_init_module_std(ctx, "qjs:std");
         js_init_module_os(ctx, "qjs:os");
 
-        _loadScript(ctx, IMPORT_STD_OS_JS, "import-std-os.js", true);
+        _importStdOs(ctx);
 
         return ctx;
     }
@@ -142,45 +283,164 @@ namespace
 
 // JSVM Internal
 
-JSValue DynXX::Core::VM::JSVM::jAwait(const JSValue obj)
+void DynXX::Core::VM::JSVM::notifySettled()
 {
-    auto ret = JS_UNDEFINED;
-    for (;;)
     {
-        /// Do not force to acquire the lock, to avoid blocking the JS event loop.
-        if (!tryLock()) [[unlikely]]
+        auto lock = std::scoped_lock(this->settleMutex);
+        this->settleCount++;
+    }
+    this->settleCv.notify_all();
+}
+
+void DynXX::Core::VM::JSVM::runPendingJobs()
+{
+    JS_UpdateStackTop(this->runtime);
+    // `os.*` timers & worker messages due now, their callbacks may queue jobs
+    js_std_loop_timer(this->context);
+    JSContext *ctx = nullptr;
+    for (auto ret = JS_ExecutePendingJob(this->runtime, &ctx); ret != 0; ret = JS_ExecutePendingJob(this->runtime, &ctx))
+    {
+        if (ret < 0) [[unlikely]]
         {
-            sleep();
-            continue;
+            dynxxLogPrint(DynXXLogLevelX::Error, "JS_ExecutePendingJob failed ->");
+            dumpJsErr(ctx);
         }
-        if (const auto state = JS_PromiseState(this->context, obj); state == JS_PROMISE_FULFILLED)
+    }
+}
+
+void DynXX::Core::VM::JSVM::scheduleJobs()
+{
+    if (this->jobsScheduled.exchange(true))
+    {
+        return;
+    }
+    this->reactor.post([this] {
+        this->jobsScheduled = false;
         {
-            ret = JS_PromiseResult(this->context, obj);
-            JS_FreeValue(this->context, obj);
-            break;
+            auto lock = std::scoped_lock(this->vmMutex);
+            this->runPendingJobs();
         }
-        else if (state == JS_PROMISE_REJECTED)
+        this->notifySettled();
+    });
+}
+
+JSValue DynXX::Core::VM::JSVM::addTimer(JSValueConst jFunc, const int64_t delayMilliSecs, const bool repeat)
+{
+    // The timer task may be released on the reactor thread, while JS runs on another thread
+    auto jFuncRef = std::shared_ptr<JSValue>(new JSValue(JS_DupValue(this->context, jFunc)), [this](JSValue *jv) {
+        auto lock = std::scoped_lock(this->vmMutex);
+        JS_FreeValue(this->context, *jv);
+        delete jv;
+    });
+    const auto delay = static_cast<size_t>(std::max<int64_t>(delayMilliSecs, 0)) * 1000uz;
+    const auto interval = repeat ? std::max(delay, MinTimerIntervalMicroSecs) : 0uz;
+    const auto id = this->reactor.addTimer(delay, interval, [this, jFuncRef] {
         {
-            ret = JS_Throw(this->context, JS_PromiseResult(this->context, obj));
-            JS_FreeValue(this->context, obj);
-            break;
+            auto lock = std::scoped_lock(this->vmMutex);
+            JS_UpdateStackTop(this->runtime);
+            const auto jRet = JS_Call(this->context, *jFuncRef, JS_UNDEFINED, 0, nullptr);
+            if (JS_IsException(jRet)) [[unlikely]]
+            {
+                dynxxLogPrint(DynXXLogLevelX::Error, "JS timer failed ->");
+                dumpJsErr(this->context);
+            }
+            JS_FreeValue(this->context, jRet);
+            this->runPendingJobs();
         }
-        else if (state == JS_PROMISE_PENDING)
+        this->notifySettled();
+    });
+    return JS_NewInt64(this->context, static_cast<int64_t>(id));
+}
+
+JSValue DynXX::Core::VM::JSVM::jSetTimer(JSContext *ctx, int argc, JSValueConst *argv, bool repeat)
+{
+    const auto vm = fromContext(ctx);
+    if (vm == nullptr || argc < 1 || !JS_IsFunction(ctx, argv[0])) [[unlikely]]
+    {
+        return JS_ThrowTypeError(ctx, "not a function");
+    }
+    int64_t delay = 0;
+    if (argc > 1 && JS_ToInt64(ctx, &delay, argv[1]) < 0) [[unlikely]]
+    {
+        return JS_EXCEPTION;
+    }
+    return vm->addTimer(argv[0], delay, repeat);
+}
+
+JSValue DynXX::Core::VM::JSVM::jSetTimeout(JS_FUNC_PARAMS)
+{
+    return jSetTimer(ctx, argc, argv, false);
+}
+
+JSValue DynXX::Core::VM::JSVM::jSetInterval(JS_FUNC_PARAMS)
+{
+    return jSetTimer(ctx, argc, argv, true);
+}
+
+JSValue DynXX::Core::VM::JSVM::jClearTimer(JS_FUNC_PARAMS)
+{
+    const auto vm = fromContext(ctx);
+    int64_t id = 0;
+    if (vm != nullptr && argc > 0 && JS_ToInt64(ctx, &id, argv[0]) == 0 && id > 0) [[likely]]
+    {
+        vm->reactor.cancelTimer(static_cast<Concurrent::Reactor::TimerId>(id));
+    }
+    return JS_UNDEFINED;
+}
+
+int DynXX::Core::VM::JSVM::jInterrupt(JSRuntime *rt, void *opaque)
+{
+    const auto deadline = static_cast<JSVM *>(opaque)->interruptDeadline.load(std::memory_order_relaxed);
+    return deadline > 0 && _steadyNanoSecs(std::chrono::steady_clock::now()) >= deadline ? 1 : 0;
+}
+
+std::optional<JSValue> DynXX::Core::VM::JSVM::jAwait(const JSValue obj, const std::chrono::steady_clock::time_point deadline)
+{
+    for (;;)
+    {
+        /// Read before checking the state, so that a settlement in between will not be missed.
+        auto settleLock = std::unique_lock(this->settleMutex);
+        const auto lastSettleCount = this->settleCount;
+        settleLock.unlock();
+
         {
-            /// Promise is executing: release the lock, sleep for a while. To avoid blocking the js event loop, or overloading CPU.
-            unlock();
-            sleep();
-            continue;
+            auto lock = std::scoped_lock(this->vmMutex);
+            const auto deadlineScope = _DeadlineScope(this->interruptDeadline, deadline);
+            /// Run reactions of the settled promises, which may settle the awaited one.
+            this->runPendingJobs();
+            if (const auto state = JS_PromiseState(this->context, obj); state == JS_PROMISE_FULFILLED)
+            {
+                const auto ret = JS_PromiseResult(this->context, obj);
+                JS_FreeValue(this->context, obj);
+                return ret;
+            }
+            else if (state == JS_PROMISE_REJECTED)
+            {
+                const auto ret = JS_Throw(this->context, JS_PromiseResult(this->context, obj));
+                JS_FreeValue(this->context, obj);
+                return ret;
+            }
+            else if (state != JS_PROMISE_PENDING)
+            {
+                /// Not a Promise: return the result immediately.
+                return obj;
+            }
         }
-        else
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= deadline)
         {
-            /// Not a Promise: release the lock, return the result immediately.
-            ret = obj;
-            break;
+            return std::nullopt;
         }
+
+        /// Promise is pending: wait without holding the VM lock, until a native promise settles or a timer fires.
+        /// Promises settled by `os.*` timers or workers do not notify, so check them again after a while.
+        const auto recheck = std::chrono::microseconds(AwaitRecheckMicroSecs);
+        settleLock.lock();
+        this->settleCv.wait_for(settleLock, deadline - now < recheck ? deadline - now : std::chrono::steady_clock::duration(recheck), [this, lastSettleCount] {
+            return this->settleCount != lastSettleCount;
+        });
     }
-    unlock();
-    return ret;
 }
 
 // JSValueHash & JSValueEqual
@@ -214,30 +474,35 @@ bool DynXX::Core::VM::JSVM::JSValueEqual::operator()(const JSValue &left, const
 
 // JSVM API
 
-DynXX::Core::VM::JSVM::JSVM()
+DynXX::Core::VM::JSVM::JSVM(const std::string &cacheRoot) : bytecodeCacheDir(prepareCodeCacheDir(cacheRoot, "js", JS_GetVersion()))
 {
     this->runtime = JS_NewRuntime();
     js_std_init_handlers(this->runtime);
     JS_SetModuleLoaderFunc(this->runtime, nullptr, js_module_loader, nullptr);
-    js_std_set_worker_new_context_func(_newContext);
+    // Process-wide in quickjs-libc, so never reset by a VM while others are alive
+    static std::once_flag workerNewContextFuncFlag;
+    std::call_once(workerNewContextFuncFlag, [] {
+        js_std_set_worker_new_context_func(_newContext);
+    });
+    JS_SetInterruptHandler(this->runtime, jInterrupt, this);
 
     this->context = _newContext(this->runtime);
     this->jGlobal = JS_GetGlobalObject(this->context);// Can not free here, will be called in future
 
-    this->executor >> [this]() {
-        if (tryLock())
-        {
-            js_std_loop_promise(context);
-            unlock();
-        }
-    };
-    this->executor >> [this]() {
-        if (tryLock())
-        {
-            js_std_loop_timer(context);
-            unlock();
-        }
+    // Global timers & the job queue run on the reactor thread, which sleeps until they are due
+    JS_SetContextOpaque(this->context, this);
+    static const JSCFunctionListEntry timerFuncs[] = {
+        JS_CFUNC_DEF("setTimeout", 2, jSetTimeout),
+        JS_CFUNC_DEF("setInterval", 2, jSetInterval),
+        JS_CFUNC_DEF("clearTimeout", 1, jClearTimer),
+        JS_CFUNC_DEF("clearInterval", 1, jClearTimer),
     };
+    this->bindFuncs(timerFuncs);
+}
+
+DynXX::Core::VM::JSVM *DynXX::Core::VM::JSVM::fromContext(JSContext *ctx)
+{
+    return static_cast<JSVM *>(JS_GetContextOpaque(ctx));
 }
 
 bool DynXX::Core::VM::JSVM::bindFunc(const std::string &funcJ, JSCFunction *funcC)
@@ -265,6 +530,18 @@ bool DynXX::Core::VM::JSVM::bindFunc(const std::string &funcJ, JSCFunction *func
     return res;
 }
 
+bool DynXX::Core::VM::JSVM::bindFuncs(std::span<const JSCFunctionListEntry> funcs)
+{
+    auto lock = std::scoped_lock(this->vmMutex);
+    if (JS_SetPropertyFunctionList(this->context, this->jGlobal, funcs.data(), static_cast<int>(funcs.size())) < 0) [[unlikely]]
+    {
+        dynxxLogPrint(DynXXLogLevelX::Error, "JS_SetPropertyFunctionList failed ->");
+        dumpJsErr(this->context);
+        return false;
+    }
+    return true;
+}
+
 bool DynXX::Core::VM::JSVM::loadFile(const std::string &file, bool isModule)
 {
     std::ifstream ifs(file.c_str());
@@ -273,61 +550,240 @@ bool DynXX::Core::VM::JSVM::loadFile(const std::string &file, bool isModule)
     return this->loadScript(ss.str(), file, isModule);
 }
 
+bool DynXX::Core::VM::JSVM::loadScriptCached(const std::string &script, const std::string &name, bool isModule)
+{
+    const auto path = _bytecodeCachePath(this->bytecodeCacheDir, script, name, isModule);
+
+    if (const auto bytes = readCodeCache(path); !bytes.empty())
+    {
+        const auto jObj = JS_ReadObject(this->context, bytes.data(), bytes.size(), JS_READ_OBJ_BYTECODE);
+        if (!JS_IsException(jObj)) [[likely]]
+        {
+            return _evalCompiled(this->context, jObj, isModule, true);
+        }
+        // Broken cache, compile again to overwrite it
+        dynxxLogPrintF(DynXXLogLevelX::Warn, "JS bytecode cache read failed: {}", path);
+        JS_FreeValue(this->context, JS_GetException(this->context));
+    }
+
+    const auto flags = (isModule ? JS_EVAL_TYPE_MODULE : JS_EVAL_TYPE_GLOBAL) | JS_EVAL_FLAG_COMPILE_ONLY;
+    const auto jObj = JS_Eval(this->context, script.c_str(), script.length(), name.c_str(), flags);
+    if (JS_IsException(jObj)) [[unlikely]]
+    {
+        dynxxLogPrint(DynXXLogLevelX::Error, "JS_Eval failed ->");
+        dumpJsErr(this->context);
+        return false;
+    }
+
+    size_t len = 0;
+    if (const auto buf = JS_WriteObject(this->context, &len, jObj, JS_WRITE_OBJ_BYTECODE)) [[likely]]
+    {
+        writeCodeCache(path, makeBytesView(buf, len));
+        js_free(this->context, buf);
+    }
+
+    return _evalCompiled(this->context, jObj, isModule, false);
+}
+
 bool DynXX::Core::VM::JSVM::loadScript(const std::string &script, const std::string &name, bool isModule) {
     auto lock = std::scoped_lock(this->vmMutex);
-    return _loadScript(this->context, script, name, isModule);
+    JS_UpdateStackTop(this->runtime);
+    const auto res = this->bytecodeCacheDir.empty() ? _loadScript(this->context, script, name, isModule)
+                                                    : this->loadScriptCached(script, name, isModule);
+    this->scheduleJobs();
+    return res;
 }
 
 bool DynXX::Core::VM::JSVM::loadBinary(const Bytes &bytes, bool isModule) {
     auto lock = std::scoped_lock(this->vmMutex);
+    JS_UpdateStackTop(this->runtime);
     return js_std_eval_binary(this->context, bytes.data(), bytes.size(), 0);
 }
 
 /// WARNING: Nested call between native and JS requires a reenterable `recursive_mutex` here!
-std::optional<std::string> DynXX::Core::VM::JSVM::callFunc(std::string_view func, std::string_view params, bool await) {
+std::expected<std::string, DynXXJsCallErrorX> DynXX::Core::VM::JSVM::callFunc(std::string_view func, std::string_view params,
+                                                                              bool await, size_t budgetMilliSecs) {
     auto lock = std::unique_lock(this->vmMutex);
-    std::string s;
-    auto success = false;
+    const auto jFunc = JS_GetPropertyStr(this->context, this->jGlobal, std::string(func).c_str());
+    if (!JS_IsFunction(this->context, jFunc)) [[unlikely]]
+    {
+        JS_FreeValue(this->context, jFunc);
+        lock.unlock();
+        dynxxLogPrintF(DynXXLogLevelX::Error, "Can not find JS func:{}", func);
+        return std::unexpected(DynXXJsCallErrorX::NotFound);
+    }
+    auto res = this->callJFunc(lock, jFunc, func, params, await, budgetMilliSecs);
+    JS_FreeValue(this->context, jFunc);
+    return res;
+}
 
-    if (const auto jFunc = JS_GetPropertyStr(this->context, this->jGlobal, func.data()); JS_IsFunction(this->context, jFunc)) [[likely]]
+std::expected<std::string, DynXXJsCallErrorX> DynXX::Core::VM::JSVM::callFunc(const FuncHandle handle, std::string_view params,
+                                                                              bool await, size_t budgetMilliSecs) {
+    auto lock = std::unique_lock(this->vmMutex);
+    const auto it = this->pinnedFuncs.find(handle);
+    if (it == this->pinnedFuncs.end()) [[unlikely]]
     {
-        const auto jParams = JS_NewString(this->context, params.data());
-        JSValue argv[] = {jParams};
+        lock.unlock();
+        dynxxLogPrintF(DynXXLogLevelX::Error, "Can not find JS func handle:{}", handle);
+        return std::unexpected(DynXXJsCallErrorX::NotFound);
+    }
+    // Pinned funcs are released only with the VM, so no need to dup it
+    return this->callJFunc(lock, it->second.jFunc, it->second.name, params, await, budgetMilliSecs);
+}
 
-        auto jRes = JS_Call(this->context, jFunc, this->jGlobal, sizeof(argv), argv);
+bool DynXX::Core::VM::JSVM::pinFunc(const FuncHandle handle, std::string_view func)
+{
+    auto lock = std::scoped_lock(this->vmMutex);
+    if (this->pinnedFuncs.contains(handle))
+    {
+        return true;
+    }
+    const auto jFunc = JS_GetPropertyStr(this->context, this->jGlobal, std::string(func).c_str());
+    if (!JS_IsFunction(this->context, jFunc)) [[unlikely]]
+    {
+        JS_FreeValue(this->context, jFunc);
+        dynxxLogPrintF(DynXXLogLevelX::Error, "Can not find JS func:{}", func);
+        return false;
+    }
+    this->pinnedFuncs.emplace(handle, PinnedFunc{.jFunc = jFunc, .name = std::string(func)});
+    return true;
+}
 
-        /// Release the lock imediately, to avoid blocking the JS event loop.
-        lock.unlock();
+std::expected<std::string, DynXXJsCallErrorX> DynXX::Core::VM::JSVM::callJFunc(std::unique_lock<std::recursive_timed_mutex> &lock,
+                                                                               JSValueConst jFunc, std::string_view func,
+                                                                               std::string_view params, bool await,
+                                                                               size_t budgetMilliSecs) {
+    const auto deadline = budgetMilliSecs > 0 ? std::chrono::steady_clock::now() + std::chrono::milliseconds(budgetMilliSecs)
+                                              : std::chrono::steady_clock::time_point::max();
+    // JS runs on different threads, the stack limit is measured from the current one
+    JS_UpdateStackTop(this->runtime);
 
-        if (JS_IsException(jRes)) [[unlikely]]
+    const auto jParams = JS_NewStringLen(this->context, params.data(), params.size());
+    JSValue argv[] = {jParams};
+
+    JSValue jRes;
+    {
+        const auto deadlineScope = _DeadlineScope(this->interruptDeadline, deadline);
+        jRes = JS_Call(this->context, jFunc, this->jGlobal, static_cast<int>(std::size(argv)), argv);
+    }
+    JS_FreeValue(this->context, jParams);
+    this->scheduleJobs();
+
+    if (JS_IsException(jRes)) [[unlikely]]
+    {
+        if (std::chrono::steady_clock::now() >= deadline)
         {
-            dynxxLogPrint(DynXXLogLevelX::Error, "JS_Call failed ->");
-            dumpJsErr(this->context);
+            dynxxLogPrintF(DynXXLogLevelX::Error, "JS func:{} interrupted after {}ms", func, budgetMilliSecs);
+            JS_FreeValue(this->context, JS_GetException(this->context));
+            return std::unexpected(DynXXJsCallErrorX::Timeout);
         }
-        else [[likely]]
+        dynxxLogPrint(DynXXLogLevelX::Error, "JS_Call failed ->");
+        dumpJsErr(this->context);
+        return std::unexpected(DynXXJsCallErrorX::Exception);
+    }
+
+    if (await)
+    {/// WARNING: Do not use built-in `js_std_await()`, since it will triger the Promise Event Loop once again.
+        /// Release the lock while awaiting, to avoid blocking the JS event loop.
+        lock.unlock();
+        auto jAwaited = this->jAwait(jRes, deadline);
+        lock.lock();
+        if (!jAwaited.has_value()) [[unlikely]]
         {
-            success = true;
-            if (await)
-            {/// WARNING: Do not use built-in `js_std_await()`, since it will triger the Promise Event Loop once again.
-                jRes = this->jAwait(jRes); // Handle promise if needed
-            }
-            const auto cS = JS_ToCString(this->context, jRes);
-            s = std::move(makeStr(cS));
-            JS_FreeCString(this->context, cS);
+            dynxxLogPrintF(DynXXLogLevelX::Error, "JS func:{} not settled in {}ms", func, budgetMilliSecs);
+            JS_FreeValue(this->context, jRes);
+            return std::unexpected(DynXXJsCallErrorX::Timeout);
+        }
+        jRes = jAwaited.value(); // Handle promise if needed
+        if (JS_IsException(jRes)) [[unlikely]]
+        {
+            dynxxLogPrint(DynXXLogLevelX::Error, "JS promise rejected ->");
+            dumpJsErr(this->context);
+            return std::unexpected(DynXXJsCallErrorX::Exception);
         }
-        JS_FreeValue(this->context, jRes);
-        JS_FreeValue(this->context, jParams);
     }
-    else [[unlikely]]
+
+    const auto cS = JS_ToCString(this->context, jRes);
+    auto res = makeStr(cS);
+    JS_FreeCString(this->context, cS);
+    JS_FreeValue(this->context, jRes);
+    return res;
+}
+
+void DynXX::Core::VM::JSVM::configure(const DynXXJsVMConfig &config)
+{
     {
-        lock.unlock();
-        dynxxLogPrintF(DynXXLogLevelX::Error, "Can not find JS func:{}", func);
+        auto lock = std::scoped_lock(this->vmMutex);
+        JS_SetMemoryLimit(this->runtime, config.memoryLimit);
+        JS_SetGCThreshold(this->runtime, config.gcThreshold > 0 ? config.gcThreshold : DefaultGCThreshold);
+        JS_SetMaxStackSize(this->runtime, config.maxStackSize > 0 ? config.maxStackSize : DefaultMaxStackSize);
     }
 
-    return success? std::make_optional(s): std::nullopt;
+    if (const auto lastTimer = this->idleGcTimer.exchange(0); lastTimer > 0)
+    {
+        this->reactor.cancelTimer(lastTimer);
+    }
+    if (config.idleGcIntervalMilliSecs > 0)
+    {
+        const auto interval = config.idleGcIntervalMilliSecs * 1000uz;
+        this->idleGcTimer = this->reactor.addTimer(interval, interval, [this] {
+            this->gcIfIdle();
+        });
+    }
+}
+
+void DynXX::Core::VM::JSVM::gcIfIdle()
+{
+    if (this->jobsScheduled)
+    {
+        return;
+    }
+    const auto lock = std::unique_lock(this->vmMutex, std::try_to_lock);
+    if (!lock.owns_lock() || JS_IsJobPending(this->runtime))
+    {
+        return;
+    }
+    JS_RunGC(this->runtime);
 }
 
-JSValue DynXX::Core::VM::JSVM::newPromise(std::function<JSValue()> &&jf)
+DynXXJsMemoryUsage DynXX::Core::VM::JSVM::memoryUsage()
+{
+    JSMemoryUsage usage;
+    {
+        auto lock = std::scoped_lock(this->vmMutex);
+        JS_ComputeMemoryUsage(this->runtime, &usage);
+    }
+    return {
+        .mallocSize = usage.malloc_size,
+        .mallocLimit = usage.malloc_limit,
+        .memoryUsedSize = usage.memory_used_size,
+        .mallocCount = usage.malloc_count,
+        .memoryUsedCount = usage.memory_used_count,
+        .atomCount = usage.atom_count,
+        .atomSize = usage.atom_size,
+        .strCount = usage.str_count,
+        .strSize = usage.str_size,
+        .objCount = usage.obj_count,
+        .objSize = usage.obj_size,
+        .propCount = usage.prop_count,
+        .propSize = usage.prop_size,
+        .shapeCount = usage.shape_count,
+        .shapeSize = usage.shape_size,
+        .jsFuncCount = usage.js_func_count,
+        .jsFuncSize = usage.js_func_size,
+        .jsFuncCodeSize = usage.js_func_code_size,
+        .jsFuncPc2lineCount = usage.js_func_pc2line_count,
+        .jsFuncPc2lineSize = usage.js_func_pc2line_size,
+        .cFuncCount = usage.c_func_count,
+        .arrayCount = usage.array_count,
+        .fastArrayCount = usage.fast_array_count,
+        .fastArrayElements = usage.fast_array_elements,
+        .binaryObjectCount = usage.binary_object_count,
+        .binaryObjectSize = usage.binary_object_size
+    };
+}
+
+JSValue DynXX::Core::VM::JSVM::newPromise(std::function<ToJSF()> &&jf, Concurrent::TaskPriority priority)
 {
     auto jPromise = _newPromise(this->context);
     if (!jPromise) [[unlikely]]
@@ -335,71 +791,150 @@ JSValue DynXX::Core::VM::JSVM::newPromise(std::function<JSValue()> &&jf)
         return JS_EXCEPTION;
     }
     
-    this->executor >> [&mtx = this->vmMutex, ctx = this->context, jPromise, cbk = std::move(jf)] {
-        auto lock = std::scoped_lock(mtx);
-
-        const auto jRet = cbk();
+    this->submit(Concurrent::Job{
+        .task = [this, &mtx = this->vmMutex, ctx = this->context, jPromise, cbk = std::move(jf)] {
+            // The work runs without the VM lock, so calls on this VM never wait for it
+            const auto toJS = cbk();
 
-        _callbackPromise(ctx, jPromise, jRet);
-    };
+            {
+                auto lock = std::scoped_lock(mtx);
+                JS_UpdateStackTop(this->runtime);
+                _callbackPromise(ctx, jPromise, toJS());
+            }
+            this->notifySettled();
+            this->scheduleJobs();
+        },
+        .priority = priority
+    });
 
     return jPromise->p;
 }
 
-JSValue DynXX::Core::VM::JSVM::newPromiseVoid(std::function<void()> &&vf)
+JSValue DynXX::Core::VM::JSVM::newPromiseVoid(std::function<void()> &&vf, Concurrent::TaskPriority priority)
 {
-    return this->newPromise([cbk = std::move(vf)]() {
+    return this->newPromise([cbk = std::move(vf)]() -> ToJSF {
         cbk();
-        return JS_UNDEFINED;
-    });
+        return [] {
+            return JS_UNDEFINED;
+        };
+    }, priority);
 }
 
-JSValue DynXX::Core::VM::JSVM::newPromiseBool(std::function<bool()> &&bf)
+JSValue DynXX::Core::VM::JSVM::newPromiseBool(std::function<bool()> &&bf, Concurrent::TaskPriority priority)
 {
-    return this->newPromise([ctx = this->context, cbk = std::move(bf)]{
+    return this->newPromise([ctx = this->context, cbk = std::move(bf)]() -> ToJSF {
         const auto ret = cbk();
-        return JS_NewBool(ctx, ret);
-    });
+        return [ctx, ret] {
+            return JS_NewBool(ctx, ret);
+        };
+    }, priority);
 }
 
-JSValue DynXX::Core::VM::JSVM::newPromiseInt32(std::function<int32_t()> &&i32f)
+JSValue DynXX::Core::VM::JSVM::newPromiseInt32(std::function<int32_t()> &&i32f, Concurrent::TaskPriority priority)
 {
-    return this->newPromise([ctx = this->context, cbk = std::move(i32f)]{
+    return this->newPromise([ctx = this->context, cbk = std::move(i32f)]() -> ToJSF {
         const auto ret = cbk();
-        return JS_NewInt32(ctx, ret);
-    });
+        return [ctx, ret] {
+            return JS_NewInt32(ctx, ret);
+        };
+    }, priority);
 }
 
-JSValue DynXX::Core::VM::JSVM::newPromiseInt64(std::function<int64_t()> &&i64f)
+JSValue DynXX::Core::VM::JSVM::newPromiseInt64(std::function<int64_t()> &&i64f, Concurrent::TaskPriority priority)
 {
-    return this->newPromise([ctx = this->context, cbk = std::move(i64f)]{
+    return this->newPromise([ctx = this->context, cbk = std::move(i64f)]() -> ToJSF {
         const auto ret = cbk();
-        return JS_NewInt64(ctx, ret);
-    });
+        return [ctx, ret] {
+            return JS_NewInt64(ctx, ret);
+        };
+    }, priority);
 }
 
-JSValue DynXX::Core::VM::JSVM::newPromiseFloat(std::function<double()> &&ff)
+JSValue DynXX::Core::VM::JSVM::newPromiseFloat(std::function<double()> &&ff, Concurrent::TaskPriority priority)
 {
-    return this->newPromise([ctx = this->context, cbk = std::move(ff)]{
+    return this->newPromise([ctx = this->context, cbk = std::move(ff)]() -> ToJSF {
         const auto ret = cbk();
-        return JS_NewFloat64(ctx, ret);
-    });
+        return [ctx, ret] {
+            return JS_NewFloat64(ctx, ret);
+        };
+    }, priority);
 }
 
-JSValue DynXX::Core::VM::JSVM::newPromiseString(std::function<const std::string()> &&sf)
+JSValue DynXX::Core::VM::JSVM::newPromiseString(std::function<const std::string()> &&sf, Concurrent::TaskPriority priority)
 {
-    return this->newPromise([ctx = this->context, cbk = std::move(sf)]{
-        const auto ret = cbk();
-        return JS_NewString(ctx, ret.c_str() != nullptr ? ret.c_str() : "");
-    });
+    return this->newPromise([ctx = this->context, cbk = std::move(sf)]() -> ToJSF {
+        auto ret = cbk();
+        return [ctx, ret = std::move(ret)] {
+            return JS_NewStringLen(ctx, ret.data(), ret.size());
+        };
+    }, priority);
+}
+
+JSValue DynXX::Core::VM::JSVM::newPromiseBytes(std::function<Bytes()> &&bf, Concurrent::TaskPriority priority)
+{
+    return this->newPromise([ctx = this->context, cbk = std::move(bf)]() -> ToJSF {
+        auto ret = cbk();
+        return [ctx, ret = std::move(ret)]() mutable {
+            return newArrayBuffer(ctx, std::move(ret));
+        };
+    }, priority);
+}
+
+BytesView DynXX::Core::VM::JSVM::toBytesView(JSContext *ctx, JSValueConst jVal)
+{
+    size_t len = 0;
+    if (JS_IsArrayBuffer(jVal))
+    {
+        const auto data = JS_GetArrayBuffer(ctx, &len, jVal);
+        return data == nullptr ? BytesView{} : BytesView{data, len};
+    }
+
+    size_t offset = 0;
+    size_t byteLen = 0;
+    size_t bytesPerElement = 0;
+    const auto jBuffer = JS_GetTypedArrayBuffer(ctx, jVal, &offset, &byteLen, &bytesPerElement);
+    if (JS_IsException(jBuffer))
+    {
+        JS_FreeValue(ctx, JS_GetException(ctx));
+        return {};
+    }
+    // The typed array keeps its buffer alive
+    const auto data = JS_GetArrayBuffer(ctx, &len, jBuffer);
+    JS_FreeValue(ctx, jBuffer);
+    if (data == nullptr || offset + byteLen > len) [[unlikely]]
+    {
+        return {};
+    }
+    return {data + offset, byteLen};
+}
+
+JSValue DynXX::Core::VM::JSVM::newArrayBuffer(JSContext *ctx, Bytes &&bytes)
+{
+    const auto holder = new(std::nothrow) Bytes(std::move(bytes));
+    if (holder == nullptr) [[unlikely]]
+    {
+        return JS_ThrowOutOfMemory(ctx);
+    }
+    return JS_NewArrayBuffer(ctx, holder->data(), holder->size(),
+                             [](JSRuntime *, void *opaque, void *) {
+                                 delete static_cast<Bytes *>(opaque);
+                             }, holder, false);
 }
 
 DynXX::Core::VM::JSVM::~JSVM()
 {
     this->active = false;
+    // Release the timers before the context
+    this->reactor.stop();
     js_std_loop_cancel(this->runtime);
+    // Jobs run on the shared Executor may outlive the VM otherwise
+    this->waitForJobs();
 
-    js_std_set_worker_new_context_func(nullptr);
+    for (const auto &[handle, pinned] : this->pinnedFuncs)
+    {
+        JS_FreeValue(this->context, pinned.jFunc);
+    }
+    this->pinnedFuncs.clear();
 
     for (const auto &jv : this->jValueCache)
     {
@@ -5,11 +5,16 @@
 
 #if defined(__cplusplus)
 
+#include <condition_variable>
+#include <span>
+#include <unordered_map>
 #include <unordered_set>
 
 #include <DynXX/CXX/Types.hxx>
+#include <DynXX/CXX/JS.hxx>
 
 #include "BaseVM.hxx"
+#include "../concurrent/Reactor.hxx"
 
 #define JS_FUNC_PARAMS                                                         \
   JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv
@@ -71,61 +76,45 @@
     }                                                                          \
   }
 
-#define DEF_JS_FUNC_VOID_ASYNC(vm, fJ, fS)                                 \
+/// The VM is read from the context, so bindings work in all the VMs of a pool
+#define DEF_JS_FUNC_ASYNC(fJ, fS, newPromiseF, priority)                       \
   static JSValue fJ(JS_FUNC_PARAMS) {                                          \
-    DEF_JS_FUNC_CHECK_VM(vm);                                          \
+    const auto vm = DynXX::Core::VM::JSVM::fromContext(ctx);                   \
+    DEF_JS_FUNC_CHECK_VM(vm);                                                  \
     std::string json = JS_FUNC_READ_JSON;                                      \
-    return bridge->newPromiseVoid(                                             \
-        [arg = json]() { return fS(arg.c_str()); });                           \
+    return vm->newPromiseF(                                                    \
+        [arg = json]() { return fS(arg.c_str()); }, priority);                 \
   }
 
-#define DEF_JS_FUNC_BOOL_ASYNC(bridge, fJ, fS)                                 \
-  static JSValue fJ(JS_FUNC_PARAMS) {                                          \
-    DEF_JS_FUNC_CHECK_VM(vm);                                          \
-    std::string json = JS_FUNC_READ_JSON;                                      \
-    return bridge->newPromiseBool(                                             \
-        [arg = json]() { return fS(arg.c_str()); });                           \
-  }
+#define DEF_JS_FUNC_VOID_ASYNC(fJ, fS, priority)                               \
+  DEF_JS_FUNC_ASYNC(fJ, fS, newPromiseVoid, priority)
 
-#define DEF_JS_FUNC_INT32_ASYNC(bridge, fJ, fS)                                \
-  static JSValue fJ(JS_FUNC_PARAMS) {                                          \
-    DEF_JS_FUNC_CHECK_VM(vm);                                          \
-    std::string json = JS_FUNC_READ_JSON;                                      \
-    return bridge->newPromiseInt32(                                            \
-        [arg = json]() { return fS(arg.c_str()); });                           \
-  }
+#define DEF_JS_FUNC_BOOL_ASYNC(fJ, fS, priority)                               \
+  DEF_JS_FUNC_ASYNC(fJ, fS, newPromiseBool, priority)
 
-#define DEF_JS_FUNC_INT64_ASYNC(bridge, fJ, fS)                                \
-  static JSValue fJ(JS_FUNC_PARAMS) {                                          \
-    DEF_JS_FUNC_CHECK_VM(vm);                                          \
-    std::string json = JS_FUNC_READ_JSON;                                      \
-    return bridge->newPromiseInt64(                                            \
-        [arg = json]() { return fS(arg.c_str()); });                           \
-  }
+#define DEF_JS_FUNC_INT32_ASYNC(fJ, fS, priority)                              \
+  DEF_JS_FUNC_ASYNC(fJ, fS, newPromiseInt32, priority)
 
-#define DEF_JS_FUNC_FLOAT_ASYNC(bridge, fJ, fS)                                \
-  static JSValue fJ(JS_FUNC_PARAMS) {                                          \
-    DEF_JS_FUNC_CHECK_VM(vm);                                          \
-    std::string json = JS_FUNC_READ_JSON;                                      \
-    return bridge->newPromiseFloat(                                            \
-        [arg = json]() { return fS(arg.c_str()); });                           \
-  }
+#define DEF_JS_FUNC_INT64_ASYNC(fJ, fS, priority)                              \
+  DEF_JS_FUNC_ASYNC(fJ, fS, newPromiseInt64, priority)
 
-#define DEF_JS_FUNC_STRING_ASYNC(bridge, fJ, fS)                               \
-  static JSValue fJ(JS_FUNC_PARAMS) {                                          \
-    DEF_JS_FUNC_CHECK_VM(vm);                                          \
-    std::string json = JS_FUNC_READ_JSON;                                      \
-    return bridge->newPromiseString(                                           \
-        [arg = json]() { return fS(arg.c_str()); });                           \
-  }
+#define DEF_JS_FUNC_FLOAT_ASYNC(fJ, fS, priority)                              \
+  DEF_JS_FUNC_ASYNC(fJ, fS, newPromiseFloat, priority)
+
+#define DEF_JS_FUNC_STRING_ASYNC(fJ, fS, priority)                             \
+  DEF_JS_FUNC_ASYNC(fJ, fS, newPromiseString, priority)
 
 namespace DynXX::Core::VM {
     class JSVM final : public BaseVM {
     public:
+        /// Handle of a pinned JS func, see `pinFunc`
+        using FuncHandle = size_t;
+
         /**
          * Create JS VM
+         * @param cacheRoot Root dir to cache the bytecode of loaded scripts, empty to disable the cache
          */
-        JSVM();
+        explicit JSVM(const std::string &cacheRoot = {});
 
         JSVM(const JSVM &) = delete;
 
@@ -135,6 +124,12 @@ namespace DynXX::Core::VM {
 
         JSVM &operator=(JSVM &&) = delete;
 
+        /**
+         * @brief Get the VM owning a JS context
+         * @return The VM, `nullptr` for contexts not created by `JSVM` (e.g. JS workers)
+         */
+        static JSVM *fromContext(JSContext *ctx);
+
         /**
          * @brief Export C func for JS
          * @param funcJ func name
@@ -143,8 +138,16 @@ namespace DynXX::Core::VM {
          */
         bool bindFunc(const std::string &funcJ, JSCFunction *funcC);
 
+        /**
+         * @brief Export C funcs for JS in one go, much faster than calling `bindFunc` one by one
+         * @param funcs Static list of funcs, defined with `JS_CFUNC_DEF`
+         * @return success or not
+         */
+        bool bindFuncs(std::span<const JSCFunctionListEntry> funcs);
+
         /**
          * @brief Load JS file
+         * @note Bytecode is read from the cache if the source is not changed, see `loadScript`.
          * @param file JS file path
          * @return success or not
          */
@@ -152,6 +155,7 @@ namespace DynXX::Core::VM {
 
         /**
          * @brief Load JS script
+         * @note With a bytecode cache dir, the compiled bytecode is cached by the hash of QuickJS version, name & source.
          * @param script JS script
          * @param name JS file name
          * @return success or not
@@ -169,26 +173,72 @@ namespace DynXX::Core::VM {
          * @param func func name
          * @param params parameters(json)
          * @param await Whether wait for the promise result or not
+         * @param budgetMilliSecs Time budget including awaiting, `0` for no limit, JS running out of it is interrupted
+         * @return The result, or `DynXXJsCallErrorX::Timeout` if the budget ran out
          */
-        [[nodiscard]] std::optional<std::string> callFunc(std::string_view func, std::string_view params,
-                                                          bool await);
+        [[nodiscard]] std::expected<std::string, DynXXJsCallErrorX> callFunc(std::string_view func, std::string_view params,
+                                                                             bool await, size_t budgetMilliSecs = 0);
+
+        /**
+         * @brief Pin a global JS func, to call it later without looking it up by name
+         * @param handle Handle chosen by the caller, pinning the same handle again does nothing
+         * @param func func name
+         * @return success or not
+         * @note The func is kept until the VM is released, even if the global is reassigned by scripts.
+         */
+        [[nodiscard]] bool pinFunc(FuncHandle handle, std::string_view func);
+
+        /**
+         * @brief call JS func pinned by `pinFunc`, see `callFunc` by name
+         */
+        [[nodiscard]] std::expected<std::string, DynXXJsCallErrorX> callFunc(FuncHandle handle, std::string_view params,
+                                                                             bool await, size_t budgetMilliSecs = 0);
+
+        /**
+         * @brief Apply the heap limit, GC & stack settings, and (re)start the idle GC timer
+         * @param config Settings, `0` fields fall back to the QuickJS defaults
+         */
+        void configure(const DynXXJsVMConfig &config);
+
+        /**
+         * @brief Compute the memory usage of the runtime
+         */
+        [[nodiscard]] DynXXJsMemoryUsage memoryUsage();
 
         /**
          * @brief New JS `Promise`
-         * @param f Callback to do work in background
+         * @param f Callback to do work in background, without the VM locked
+         * @param priority Priority of the background work
          * @return JSValue of the `Promise`
          */
-        JSValue newPromiseVoid(std::function<void()> &&f);
+        JSValue newPromiseVoid(std::function<void()> &&f, Concurrent::TaskPriority priority = Concurrent::TaskPriority::Normal);
 
-        JSValue newPromiseBool(std::function<bool()> &&f);
+        JSValue newPromiseBool(std::function<bool()> &&f, Concurrent::TaskPriority priority = Concurrent::TaskPriority::Normal);
 
-        JSValue newPromiseInt32(std::function<int32_t()> &&f);
+        JSValue newPromiseInt32(std::function<int32_t()> &&f, Concurrent::TaskPriority priority = Concurrent::TaskPriority::Normal);
 
-        JSValue newPromiseInt64(std::function<int64_t()> &&f);
+        JSValue newPromiseInt64(std::function<int64_t()> &&f, Concurrent::TaskPriority priority = Concurrent::TaskPriority::Normal);
 
-        JSValue newPromiseFloat(std::function<double()> &&f);
+        JSValue newPromiseFloat(std::function<double()> &&f, Concurrent::TaskPriority priority = Concurrent::TaskPriority::Normal);
 
-        JSValue newPromiseString(std::function<const std::string()> &&f);
+        JSValue newPromiseString(std::function<const std::string()> &&f, Concurrent::TaskPriority priority = Concurrent::TaskPriority::Normal);
+
+        /**
+         * @brief New JS `Promise` resolved with an `ArrayBuffer`, see `newArrayBuffer`
+         */
+        JSValue newPromiseBytes(std::function<Bytes()> &&f, Concurrent::TaskPriority priority = Concurrent::TaskPriority::Normal);
+
+        /**
+         * @brief View the bytes of an `ArrayBuffer` or a typed array (e.g. `Uint8Array`), without copying
+         * @return Empty if `jVal` is neither of them
+         * @warning Only valid during the current native call, copy it for background work.
+         */
+        static BytesView toBytesView(JSContext *ctx, JSValueConst jVal);
+
+        /**
+         * @brief New JS `ArrayBuffer` taking over `bytes`, without copying
+         */
+        static JSValue newArrayBuffer(JSContext *ctx, Bytes &&bytes);
 
         ~JSVM() override;
 
@@ -196,6 +246,7 @@ namespace DynXX::Core::VM {
         JSRuntime *runtime{nullptr};
         JSContext *context{nullptr};
         JSValue jGlobal{JS_UNDEFINED};
+        const std::string bytecodeCacheDir;
 
         // Custom hash function for JSValue
         struct JSValueHash {
@@ -209,9 +260,91 @@ namespace DynXX::Core::VM {
 
         std::unordered_set<JSValue, JSValueHash, JSValueEqual> jValueCache;
 
-        JSValue newPromise(std::function<JSValue()> &&jf);
+        struct PinnedFunc {
+            JSValue jFunc{JS_UNDEFINED};
+            std::string name;
+        };
+
+        std::unordered_map<FuncHandle, PinnedFunc> pinnedFuncs;
+
+        std::mutex settleMutex;
+        std::condition_variable settleCv;
+        uint64_t settleCount{0};
+
+        std::atomic<bool> jobsScheduled{false};
+        /// Deadline of the running call in nanoseconds of `steady_clock`, `0` for no deadline
+        std::atomic<int64_t> interruptDeadline{0};
+        std::atomic<Concurrent::Reactor::TimerId> idleGcTimer{0};
+        Concurrent::Reactor reactor{"DynXX-JS"};
+
+        /// Converts the result of the background work to JS, called with `vmMutex` locked
+        using ToJSF = std::function<JSValue()>;
+
+        /**
+         * @brief New JS `Promise` settled by background work
+         * @param jf Runs on the shared Executor without `vmMutex`, returns the conversion of its result
+         */
+        JSValue newPromise(std::function<ToJSF()> &&jf, Concurrent::TaskPriority priority);
+
+        /**
+         * @brief Call `jFunc` with `lock` of `vmMutex` locked
+         * @note The lock is released only while awaiting, and locked again on return, so all JS values are accessed with it.
+         */
+        std::expected<std::string, DynXXJsCallErrorX> callJFunc(std::unique_lock<std::recursive_timed_mutex> &lock,
+                                                                JSValueConst jFunc, std::string_view func,
+                                                                std::string_view params, bool await,
+                                                                size_t budgetMilliSecs);
+
+        /**
+         * @brief Load JS script through the bytecode cache, must be called with `vmMutex` locked
+         */
+        bool loadScriptCached(const std::string &script, const std::string &name, bool isModule);
+
+        /**
+         * @brief Wake up the threads awaiting promises, called when a native promise settles
+         */
+        void notifySettled();
+
+        /**
+         * @brief Run pending JS jobs, e.g. reactions of settled promises, must be called with `vmMutex` locked
+         * @note Also serves the `os.*` timers & workers of quickjs-libc, on each wake up of the reactor or an awaiting call.
+         */
+        void runPendingJobs();
+
+        /**
+         * @brief Run pending JS jobs on the reactor thread, multiple calls before it runs are merged
+         */
+        void scheduleJobs();
 
-        JSValue jAwait(const JSValue obj);
+        /**
+         * @brief Add a timer running `jFunc` on the reactor thread, must be called with `vmMutex` locked
+         * @return JS timer id
+         */
+        JSValue addTimer(JSValueConst jFunc, int64_t delayMilliSecs, bool repeat);
+
+        /**
+         * @brief Run GC on the reactor thread, skipped if JS is running or jobs are pending
+         */
+        void gcIfIdle();
+
+        static JSValue jSetTimer(JSContext *ctx, int argc, JSValueConst *argv, bool repeat);
+
+        static JSValue jSetTimeout(JS_FUNC_PARAMS);
+
+        static JSValue jSetInterval(JS_FUNC_PARAMS);
+
+        static JSValue jClearTimer(JS_FUNC_PARAMS);
+
+        /**
+         * @brief Interrupt handler of the runtime, interrupts JS when the deadline of the running call passes
+         */
+        static int jInterrupt(JSRuntime *rt, void *opaque);
+
+        /**
+         * @brief Await a promise until it settles or the deadline passes
+         * @return The result, `std::nullopt` if the deadline passed, while `obj` is not released
+         */
+        std::optional<JSValue> jAwait(const JSValue obj, std::chrono::steady_clock::time_point deadline);
     };
 }
 
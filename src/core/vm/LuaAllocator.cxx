@@ -0,0 +1,333 @@
+#if defined(USE_LUA)
+#include "LuaAllocator.hxx"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+namespace
+{
+    void *allocChunk(const size_t size)
+    {
+#if defined(_WIN32)
+        return _aligned_malloc(size, size);
+#else
+        return std::aligned_alloc(size, size);
+#endif
+    }
+
+    void freeChunk(void *chunk)
+    {
+#if defined(_WIN32)
+        _aligned_free(chunk);
+#else
+        std::free(chunk);
+#endif
+    }
+}
+
+DynXX::Core::VM::LuaAllocator::~LuaAllocator()
+{
+    for (auto lists : {&this->partialSlabs, &this->fullSlabs})
+    {
+        for (auto slab : *lists)
+        {
+            while (slab != nullptr)
+            {
+                freeChunk(std::exchange(slab, slab->next));
+            }
+        }
+    }
+    for (const auto &[block, _] : this->shrunkBlocks)
+    {
+        std::free(block);
+    }
+}
+
+void *DynXX::Core::VM::LuaAllocator::alloc(void *ud, void *ptr, size_t osize, size_t nsize) noexcept
+{
+    const auto self = static_cast<LuaAllocator *>(ud);
+    // For a new block, `osize` is the type of the object, not a size
+    const auto oldSize = ptr != nullptr ? osize : 0uz;
+
+    if (nsize == 0)
+    {
+        if (ptr != nullptr)
+        {
+            self->release(ptr, osize);
+            self->usedSize.fetch_sub(osize, std::memory_order_relaxed);
+        }
+        return nullptr;
+    }
+
+    const auto p = ptr != nullptr ? self->reallocate(ptr, osize, nsize) : self->allocate(nsize);
+    if (p == nullptr) [[unlikely]]
+    {
+        self->failedCount.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    if (ptr == nullptr)
+    {
+        self->allocCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    const auto newUsed = self->usedSize.load(std::memory_order_relaxed) - oldSize + nsize;
+    self->usedSize.store(newUsed, std::memory_order_relaxed);
+    if (newUsed > self->peakSize.load(std::memory_order_relaxed))
+    {
+        self->peakSize.store(newUsed, std::memory_order_relaxed);
+    }
+    return p;
+}
+
+void DynXX::Core::VM::LuaAllocator::setLimit(const size_t limit)
+{
+    this->limit.store(limit, std::memory_order_relaxed);
+}
+
+DynXXLuaMemoryStats DynXX::Core::VM::LuaAllocator::stats() const
+{
+    return {
+        .usedSize = static_cast<int64_t>(this->usedSize.load(std::memory_order_relaxed)),
+        .peakSize = static_cast<int64_t>(this->peakSize.load(std::memory_order_relaxed)),
+        .limitSize = static_cast<int64_t>(this->limit.load(std::memory_order_relaxed)),
+        .arenaSize = static_cast<int64_t>(this->arenaSize.load(std::memory_order_relaxed)),
+        .allocCount = static_cast<int64_t>(this->allocCount.load(std::memory_order_relaxed)),
+        .failedCount = static_cast<int64_t>(this->failedCount.load(std::memory_order_relaxed)),
+    };
+}
+
+DynXX::Core::VM::LuaAllocator::Slab *DynXX::Core::VM::LuaAllocator::slabOf(void *ptr)
+{
+    return reinterpret_cast<Slab *>(reinterpret_cast<uintptr_t>(ptr) & ~(ArenaChunkSize - 1));
+}
+
+bool DynXX::Core::VM::LuaAllocator::withinLimit(const size_t growth) const
+{
+    const auto limit = this->limit.load(std::memory_order_relaxed);
+    if (limit == 0) [[likely]]
+    {
+        return true;
+    }
+    const auto taken = this->arenaSize.load(std::memory_order_relaxed) + this->largeSize.load(std::memory_order_relaxed);
+    return taken + growth <= limit;
+}
+
+void *DynXX::Core::VM::LuaAllocator::allocate(const size_t size)
+{
+    return size > MaxPooledSize ? this->allocateLarge(size) : this->allocateSmall(size);
+}
+
+void *DynXX::Core::VM::LuaAllocator::allocateLarge(const size_t size)
+{
+    if (!this->withinLimit(size)) [[unlikely]]
+    {
+        return nullptr;
+    }
+    const auto p = std::malloc(size);
+    if (p != nullptr) [[likely]]
+    {
+        this->largeSize.fetch_add(size, std::memory_order_relaxed);
+    }
+    return p;
+}
+
+void *DynXX::Core::VM::LuaAllocator::allocateSmall(const size_t size)
+{
+    const auto i = sizeClass(size);
+    auto slab = this->partialSlabs[i];
+    if (slab == nullptr)
+    {
+        if (!this->withinLimit(ArenaChunkSize)) [[unlikely]]
+        {
+            return nullptr;
+        }
+        const auto chunk = allocChunk(ArenaChunkSize);
+        if (chunk == nullptr) [[unlikely]]
+        {
+            return nullptr;
+        }
+        slab = new (chunk) Slab{
+            .prev = nullptr,
+            .next = nullptr,
+            .freeList = nullptr,
+            .cur = static_cast<std::byte *>(chunk) + sizeof(Slab),
+            .sizeClass = i,
+            .liveCount = 0,
+        };
+        linkSlab(this->partialSlabs[i], slab);
+        this->arenaSize.fetch_add(ArenaChunkSize, std::memory_order_relaxed);
+    }
+
+    void *block;
+    if (slab->freeList != nullptr)
+    {
+        block = std::exchange(slab->freeList, slab->freeList->next);
+    }
+    else
+    {
+        // Carve from the untouched part, the tail is dropped if too small
+        const auto blockSize = (i + 1) * SizeClassStep;
+        block = std::exchange(slab->cur, slab->cur + blockSize);
+        if (reinterpret_cast<std::byte *>(slab) + ArenaChunkSize - slab->cur < static_cast<ptrdiff_t>(blockSize))
+        {
+            slab->cur = nullptr;
+        }
+    }
+    ++slab->liveCount;
+    if (slab->freeList == nullptr && slab->cur == nullptr)
+    {
+        unlinkSlab(this->partialSlabs[i], slab);
+        linkSlab(this->fullSlabs[i], slab);
+    }
+    return block;
+}
+
+void *DynXX::Core::VM::LuaAllocator::reallocate(void *ptr, const size_t osize, const size_t nsize)
+{
+    auto largeSize = osize;
+    auto shrunk = this->shrunkBlocks.end();
+    if (!this->shrunkBlocks.empty()) [[unlikely]]
+    {
+        shrunk = this->shrunkBlocks.find(ptr);
+        if (shrunk != this->shrunkBlocks.end())
+        {
+            if (nsize <= MaxPooledSize)
+            {
+                return ptr;
+            }
+            largeSize = shrunk->second;
+        }
+    }
+
+    if (largeSize > MaxPooledSize && nsize > MaxPooledSize)
+    {
+        if (nsize > largeSize && !this->withinLimit(nsize - largeSize)) [[unlikely]]
+        {
+            return nullptr;
+        }
+        auto p = std::realloc(ptr, nsize);
+        if (p == nullptr) [[unlikely]]
+        {
+            if (nsize > largeSize)
+            {
+                return nullptr;
+            }
+            // Kept in place, counted as shrunk since Lua frees it with the new size
+            p = ptr;
+        }
+        this->largeSize.fetch_add(nsize, std::memory_order_relaxed);
+        this->largeSize.fetch_sub(largeSize, std::memory_order_relaxed);
+        if (shrunk != this->shrunkBlocks.end())
+        {
+            this->shrunkBlocks.erase(shrunk);
+        }
+        return p;
+    }
+    if (osize <= MaxPooledSize && nsize <= MaxPooledSize && slabOf(ptr)->sizeClass == sizeClass(nsize))
+    {
+        return ptr;
+    }
+
+    const auto p = this->allocate(nsize);
+    if (p == nullptr) [[unlikely]]
+    {
+        if (nsize > osize)
+        {
+            return nullptr;
+        }
+        // Lua assumes a shrink never fails, so keep the block in place;
+        // a pooled one stays in its slab, a large one is tracked so it is not taken for a pooled one later.
+        // Failing to allocate the tracking node means the process is out of memory, `alloc` terminates then.
+        if (osize > MaxPooledSize)
+        {
+            this->shrunkBlocks.emplace(ptr, osize);
+        }
+        return ptr;
+    }
+    std::memcpy(p, ptr, std::min(osize, nsize));
+    this->release(ptr, osize);
+    return p;
+}
+
+void DynXX::Core::VM::LuaAllocator::release(void *ptr, const size_t size)
+{
+    if (!this->shrunkBlocks.empty()) [[unlikely]]
+    {
+        if (const auto it = this->shrunkBlocks.find(ptr); it != this->shrunkBlocks.end())
+        {
+            this->largeSize.fetch_sub(it->second, std::memory_order_relaxed);
+            this->shrunkBlocks.erase(it);
+            std::free(ptr);
+            return;
+        }
+    }
+    if (size > MaxPooledSize)
+    {
+        this->largeSize.fetch_sub(size, std::memory_order_relaxed);
+        std::free(ptr);
+        return;
+    }
+    this->releaseSmall(ptr);
+}
+
+void DynXX::Core::VM::LuaAllocator::releaseSmall(void *ptr)
+{
+    const auto slab = slabOf(ptr);
+    const auto i = slab->sizeClass;
+    const auto wasFull = slab->freeList == nullptr && slab->cur == nullptr;
+
+    const auto block = static_cast<FreeBlock *>(ptr);
+    block->next = slab->freeList;
+    slab->freeList = block;
+    --slab->liveCount;
+
+    if (wasFull)
+    {
+        unlinkSlab(this->fullSlabs[i], slab);
+        linkSlab(this->partialSlabs[i], slab);
+    }
+    // Return an empty slab to the system, unless it is the last one of its class, to avoid thrashing at the boundary
+    if (slab->liveCount == 0 && (slab->prev != nullptr || slab->next != nullptr))
+    {
+        unlinkSlab(this->partialSlabs[i], slab);
+        freeChunk(slab);
+        this->arenaSize.fetch_sub(ArenaChunkSize, std::memory_order_relaxed);
+    }
+}
+
+void DynXX::Core::VM::LuaAllocator::unlinkSlab(Slab *&list, Slab *slab)
+{
+    if (slab->prev != nullptr)
+    {
+        slab->prev->next = slab->next;
+    }
+    else
+    {
+        list = slab->next;
+    }
+    if (slab->next != nullptr)
+    {
+        slab->next->prev = slab->prev;
+    }
+    slab->prev = nullptr;
+    slab->next = nullptr;
+}
+
+void DynXX::Core::VM::LuaAllocator::linkSlab(Slab *&list, Slab *slab)
+{
+    slab->prev = nullptr;
+    slab->next = list;
+    if (list != nullptr)
+    {
+        list->prev = slab;
+    }
+    list = slab;
+}
+#endif
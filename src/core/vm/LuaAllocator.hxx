@@ -0,0 +1,117 @@
+#ifndef DYNXX_SRC_CORE_VM_LUAALLOCATOR_HXX_
+#define DYNXX_SRC_CORE_VM_LUAALLOCATOR_HXX_
+
+#if defined(__cplusplus)
+
+#include <array>
+#include <atomic>
+#include <unordered_map>
+
+#include <DynXX/CXX/Lua.hxx>
+
+namespace DynXX::Core::VM {
+
+    /**
+     * @brief Allocator of a `lua_State`, passed to `lua_newstate` as `lua_Alloc`
+     * @note Small blocks are served by size-class slabs, larger ones by `malloc`.
+     * A slab is an aligned arena chunk of one size class, returned to the system once all its blocks are freed.
+     * Lua passes the block size back on each realloc/free, so blocks carry no header.
+     * @warning Not thread-safe, a state is only accessed with its VM locked; only the counters & limit may be accessed concurrently.
+     */
+    class LuaAllocator final {
+    public:
+        LuaAllocator() = default;
+
+        LuaAllocator(const LuaAllocator &) = delete;
+
+        LuaAllocator &operator=(const LuaAllocator &) = delete;
+
+        LuaAllocator(LuaAllocator &&) = delete;
+
+        LuaAllocator &operator=(LuaAllocator &&) = delete;
+
+        /**
+         * @brief Release the remaining slabs, must be called after the state is closed
+         */
+        ~LuaAllocator();
+
+        /**
+         * @brief `lua_Alloc` implementation, `ud` is the `LuaAllocator`
+         * @note Growing beyond the limit fails with `nullptr`, then Lua runs an emergency GC & retries before raising a memory error.
+         * Shrinking never fails, the block is kept as is if it can not be moved.
+         */
+        static void *alloc(void *ud, void *ptr, size_t osize, size_t nsize) noexcept;
+
+        /**
+         * @brief Set the hard limit of memory taken by the state, i.e. the large blocks plus the slabs
+         * @param limit Limit in bytes, `0` for no limit
+         * @note Slabs are counted as a whole, so the limit is reached before `usedSize` does.
+         */
+        void setLimit(size_t limit);
+
+        [[nodiscard]] DynXXLuaMemoryStats stats() const;
+
+    private:
+        static constexpr auto SizeClassStep = 16uz;
+        static constexpr auto MaxPooledSize = 256uz;
+        static constexpr auto SizeClassCount = MaxPooledSize / SizeClassStep;
+        static constexpr auto ArenaChunkSize = 64uz * 1024uz;
+
+        struct FreeBlock {
+            FreeBlock *next;
+        };
+
+        /// Header at the beginning of a slab, found by aligning a block address down
+        struct alignas(SizeClassStep) Slab {
+            Slab *prev;
+            Slab *next;
+            FreeBlock *freeList;
+            std::byte *cur;
+            size_t sizeClass;
+            size_t liveCount;
+        };
+
+        /// Slabs of each size class with free blocks, the full ones are unlinked until a block is freed
+        std::array<Slab *, SizeClassCount> partialSlabs{};
+        std::array<Slab *, SizeClassCount> fullSlabs{};
+        /// Large blocks kept in place by a failed shrink, Lua sees them as small, mapped to their real size
+        std::unordered_map<void *, size_t> shrunkBlocks;
+
+        std::atomic<size_t> limit{0};
+        std::atomic<size_t> usedSize{0};
+        std::atomic<size_t> peakSize{0};
+        std::atomic<size_t> arenaSize{0};
+        std::atomic<size_t> largeSize{0};
+        std::atomic<size_t> allocCount{0};
+        std::atomic<size_t> failedCount{0};
+
+        static constexpr size_t sizeClass(const size_t size)
+        {
+            return (size - 1) / SizeClassStep;
+        }
+
+        static Slab *slabOf(void *ptr);
+
+        [[nodiscard]] bool withinLimit(size_t growth) const;
+
+        void *allocate(size_t size);
+
+        void *allocateLarge(size_t size);
+
+        void *allocateSmall(size_t size);
+
+        void *reallocate(void *ptr, size_t osize, size_t nsize);
+
+        void release(void *ptr, size_t size);
+
+        void releaseSmall(void *ptr);
+
+        static void unlinkSlab(Slab *&list, Slab *slab);
+
+        static void linkSlab(Slab *&list, Slab *slab);
+    };
+}
+
+#endif
+
+#endif // DYNXX_SRC_CORE_VM_LUAALLOCATOR_HXX_
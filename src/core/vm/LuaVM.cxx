@@ -3,138 +3,311 @@
 
 #if defined(USE_LIBUV)
 #include <uv.h>
+
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <vector>
 #endif
 
+#include <fstream>
+#include <sstream>
+
 #include <DynXX/CXX/Log.hxx>
 #include <DynXX/CXX/Types.hxx>
 
+#include "../coding/Coding.hxx"
+#include "../crypto/Crypto.hxx"
+#if defined(USE_LIBUV)
+#include "../concurrent/ThreadUtil.hxx"
+#endif
+
 namespace
 {
-#if defined(USE_LIBUV)
-    struct Timer
+    #define lua_register_lib(L, lib, funcs)    \
+    {                                          \
+        luaL_newlib(L, funcs);                 \
+        lua_setglobal(L, lib);                 \
+    }
+
+    #define PRINT_L_ERROR(L, prefix)                                            \
+    do                                                                          \
+    {                                                                           \
+        const char *luaErrMsg = lua_tostring(L, -1);                            \
+        if (luaErrMsg != nullptr)                                               \
+        {                                                                       \
+            dynxxLogPrintF(DynXXLogLevelX::Error, "{}{}", prefix, luaErrMsg); \
+        }                                                                       \
+    } while (0)
+
+    /// Same as the panic handler of `luaL_newstate`, the state is created with `lua_newstate` for the custom allocator
+    int _panic(lua_State *L)
     {
-        lua_State *lState{nullptr};
-        int lFuncRef{0};
-        lua_Integer timeout{1};
-        bool repeat{false};
-        bool finished{false};
-    };
+        PRINT_L_ERROR(L, "Lua panic:");
+        return 0;
+    }
 
-    void _loop_init()
+    std::string _chunkCachePath(const std::string &dir, const std::string &script, const std::string &chunkName)
     {
-        uv_loop_init(uv_default_loop());
+        // Chunks are not compatible between Lua versions, and embed the chunk name for error messages
+        std::string key(LUA_RELEASE);
+        key.push_back('\0');
+        key.append(chunkName);
+        key.push_back('\0');
+        key.append(script);
+        const auto hash = DynXX::Core::Crypto::Hash::sha256(makeBytesView(reinterpret_cast<const byte *>(key.data()), key.size()));
+        return dir + "/" + DynXX::Core::Coding::Hex::bytes2str(hash) + ".luac";
     }
 
-    void _loop_prepare()
+    int _chunkWriter(lua_State *, const void *p, const size_t sz, void *ud)
     {
-        uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+        const auto begin = static_cast<const byte *>(p);
+        static_cast<Bytes *>(ud)->insert(static_cast<Bytes *>(ud)->end(), begin, begin + sz);
+        return 0;
     }
 
-    void _loop_stop()
+    /// Load a chunk, source or binary by `mode`, leaving the error message popped if failed
+    bool _loadChunk(lua_State *L, const char *buf, const size_t len, const std::string &chunkName, const char *mode)
     {
-        if (!uv_loop_alive(uv_default_loop())) [[unlikely]]
+        if (const auto ret = luaL_loadbufferx(L, buf, len, chunkName.c_str(), mode); ret != LUA_OK) [[unlikely]]
         {
-            return;
+            PRINT_L_ERROR(L, "`luaL_loadbuffer` error:");
+            lua_pop(L, 1);
+            return false;
         }
-        uv_stop(uv_default_loop());
-        uv_loop_close(uv_default_loop());
+        return true;
     }
 
-    void _timer_cb(uv_timer_t *timer)
+    /// Run the loaded chunk on the top of the stack
+    bool _runChunk(lua_State *L)
     {
-        const auto timer_data = static_cast<Timer *>(timer->data);
-        lua_rawgeti(timer_data->lState, LUA_REGISTRYINDEX, timer_data->lFuncRef);
-        lua_pcall(timer_data->lState, 0, 0, 0);
+        if (const auto ret = lua_pcall(L, 0, 0, 0); ret != LUA_OK) [[unlikely]]
+        {
+            PRINT_L_ERROR(L, "`lua_pcall` error:");
+            lua_pop(L, 1);
+            return false;
+        }
+        return true;
     }
+}
+
+#if defined(USE_LIBUV)
+struct DynXX::Core::VM::LuaVM::Timer
+{
+    uv_timer_t handle{};
+    LuaVM *vm{nullptr};
+    lua_Integer id{0};
+    int lFuncRef{LUA_NOREF};
+    uint64_t timeout{0};
+    bool repeat{false};
+};
 
-    uv_timer_t *_timer_start(Timer *timer_data)
+/// A libuv loop on its own thread, other threads post tasks to it through `uv_async_t`
+class DynXX::Core::VM::LuaVM::TimerLoop final
+{
+public:
+    TimerLoop()
     {
-        auto timerP = mallocX<uv_timer_t>();
-        timerP->data = timer_data;
+        uv_loop_init(&this->loop);
+        uv_async_init(&this->loop, &this->async, onAsync);
+        this->async.data = this;
+        this->thread = std::thread([this] {
+            Concurrent::setCurrentThreadName("DynXX-Lua");
+            uv_run(&this->loop, UV_RUN_DEFAULT);
+        });
+    }
 
-        std::thread([timerP] {
-            uv_timer_init(uv_default_loop(), timerP);
-            const auto data = static_cast<Timer *>(timerP->data);
-            uv_timer_start(timerP, _timer_cb, data->timeout, data->repeat ? data->timeout : 0);
-            _loop_prepare();
-        }).detach();
+    TimerLoop(const TimerLoop &) = delete;
 
-        return timerP;
-    }
+    TimerLoop &operator=(const TimerLoop &) = delete;
+
+    TimerLoop(TimerLoop &&) = delete;
 
-    void _timer_stop(uv_timer_t *timer, bool release)
+    TimerLoop &operator=(TimerLoop &&) = delete;
+
+    /// Run the pending tasks, close all handles & timers, then wait for the loop thread to exit
+    ~TimerLoop()
     {
-        const auto timer_data = static_cast<Timer *>(timer->data);
-        luaL_unref(timer_data->lState, LUA_REGISTRYINDEX, timer_data->lFuncRef);
-        if (!timer_data->finished)
         {
-            uv_timer_set_repeat(timer, 0);
-            uv_timer_stop(timer);
-            timer_data->finished = true;
+            auto lock = std::scoped_lock(this->mutex);
+            this->stopping = true;
+        }
+        uv_async_send(&this->async);
+        if (this->thread.joinable())
+        {
+            this->thread.join();
         }
-        if (release)
+        uv_loop_close(&this->loop);
+    }
+
+    /// Run `task` on the loop thread, which is the only thread touching libuv handles
+    void post(std::function<void()> &&task)
+    {
         {
-            freeX(timer->data);
-            freeX(timer);
+            auto lock = std::scoped_lock(this->mutex);
+            this->tasks.emplace_back(std::move(task));
         }
+        uv_async_send(&this->async);
     }
 
-    int _util_timer_add(lua_State *L)
+    void startTimer(Timer *timer)
     {
-        const auto timer_data = mallocX<Timer>();
-        *timer_data = {
-            .lState = L,
-            .lFuncRef = luaL_ref(L, LUA_REGISTRYINDEX),
-            .timeout = lua_tointeger(L, 1),
-            .repeat = static_cast<bool>(lua_toboolean(L, 2))
-        };
+        this->post([this, timer] {
+            uv_timer_init(&this->loop, &timer->handle);
+            const auto interval = timer->repeat ? std::max<uint64_t>(timer->timeout, 1) : 0;
+            uv_timer_start(&timer->handle, onTimer, timer->timeout, interval);
+        });
+    }
 
-        const auto timer = _timer_start(timer_data);
+    void stopTimer(Timer *timer)
+    {
+        this->post([timer] {
+            closeTimer(timer);
+        });
+    }
 
-        lua_pushlightuserdata(L, timer);
-        return LUA_OK;
+    /// Must be called on the loop thread, `timer` is released after closed
+    static void closeTimer(Timer *timer)
+    {
+        uv_timer_stop(&timer->handle);
+        uv_close(reinterpret_cast<uv_handle_t *>(&timer->handle), onTimerClosed);
     }
 
-    int _util_timer_remove(lua_State *L)
+private:
+    uv_loop_t loop{};
+    uv_async_t async{};
+    std::mutex mutex;
+    std::vector<std::function<void()>> tasks;
+    bool stopping{false};
+    std::thread thread;
+
+    static void onAsync(uv_async_t *handle)
     {
-        if (const auto timer = static_cast<uv_timer_t *>(lua_touserdata(L, 1)); timer != nullptr) [[likely]]
+        const auto self = static_cast<TimerLoop *>(handle->data);
+        std::vector<std::function<void()>> readyTasks;
+        auto stopping = false;
+        {
+            auto lock = std::scoped_lock(self->mutex);
+            readyTasks.swap(self->tasks);
+            stopping = self->stopping;
+        }
+        for (auto &task : readyTasks)
+        {
+            task();
+        }
+        if (stopping)
         {
-            _timer_stop(timer, true);
+            // The loop exits when no handle is left
+            uv_walk(&self->loop, closeHandle, nullptr);
         }
-        return LUA_OK;
     }
 
-    constexpr luaL_Reg lib_timer_funcs[] = {
-        {"add", _util_timer_add},
-        {"remove", _util_timer_remove},
-        {nullptr, nullptr} /* sentinel */
-    };
-#endif
+    static void closeHandle(uv_handle_t *handle, void *)
+    {
+        if (uv_is_closing(handle))
+        {
+            return;
+        }
+        uv_close(handle, uv_handle_get_type(handle) == UV_TIMER ? onTimerClosed : nullptr);
+    }
 
-    #define lua_register_lib(L, lib, funcs)    \
-    {                                          \
-        luaL_newlib(L, funcs);                 \
-        lua_setglobal(L, lib);                 \
+    static void onTimer(uv_timer_t *handle)
+    {
+        const auto timer = static_cast<Timer *>(handle->data);
+        timer->vm->runTimer(timer);
     }
 
-    #define PRINT_L_ERROR(L, prefix)                                            \
-    do                                                                          \
-    {                                                                           \
-        const char *luaErrMsg = lua_tostring(L, -1);                            \
-        if (luaErrMsg != nullptr)                                               \
-        {                                                                       \
-            dynxxLogPrintF(DynXXLogLevelX::Error, "{}{}", prefix, luaErrMsg); \
-        }                                                                       \
-    } while (0)
+    static void onTimerClosed(uv_handle_t *handle)
+    {
+        delete static_cast<Timer *>(handle->data);
+    }
+};
+
+void DynXX::Core::VM::LuaVM::runTimer(Timer *timer)
+{
+    auto lock = std::scoped_lock(this->vmMutex);
+    // Removed by Lua while this callback was waiting for the lock
+    if (!this->timers.contains(timer->id))
+    {
+        return;
+    }
+    lua_rawgeti(this->lstate, LUA_REGISTRYINDEX, timer->lFuncRef);
+    if (const auto ret = lua_pcall(this->lstate, 0, 0, 0); ret != LUA_OK) [[unlikely]]
+    {
+        PRINT_L_ERROR(this->lstate, "Lua timer error:");
+        lua_pop(this->lstate, 1);
+    }
+    // The callback may remove the timer itself
+    if (!timer->repeat && this->timers.erase(timer->id) > 0)
+    {
+        luaL_unref(this->lstate, LUA_REGISTRYINDEX, timer->lFuncRef);
+        TimerLoop::closeTimer(timer);
+    }
+}
+
+/// `Timer.add(timeout, repeat, func)` returns the timer id, called with `vmMutex` locked
+int DynXX::Core::VM::LuaVM::lTimerAdd(lua_State *L)
+{
+    const auto vm = fromState(L);
+    if (vm == nullptr || !vm->timerLoop) [[unlikely]]
+    {
+        return luaL_error(L, "Timer is not available");
+    }
+    luaL_checktype(L, 3, LUA_TFUNCTION);
+
+    const auto timer = new Timer{
+        .vm = vm,
+        .id = vm->nextTimerId++,
+        .timeout = static_cast<uint64_t>(std::max<lua_Integer>(lua_tointeger(L, 1), 0)),
+        .repeat = static_cast<bool>(lua_toboolean(L, 2))
+    };
+    timer->handle.data = timer;
+    lua_settop(L, 3);
+    timer->lFuncRef = luaL_ref(L, LUA_REGISTRYINDEX);
+
+    vm->timers.emplace(timer->id, timer);
+    vm->timerLoop->startTimer(timer);
+
+    lua_pushinteger(L, timer->id);
+    return 1;
+}
+
+/// `Timer.remove(id)`, called with `vmMutex` locked
+int DynXX::Core::VM::LuaVM::lTimerRemove(lua_State *L)
+{
+    const auto vm = fromState(L);
+    const auto id = luaL_checkinteger(L, 1);
+    if (vm == nullptr) [[unlikely]]
+    {
+        return 0;
+    }
+    const auto it = vm->timers.find(id);
+    if (it == vm->timers.end())
+    {
+        return 0;
+    }
+    const auto timer = it->second;
+    vm->timers.erase(it);
+    luaL_unref(L, LUA_REGISTRYINDEX, timer->lFuncRef);
+    vm->timerLoop->stopTimer(timer);
+    return 0;
 }
+#endif
 
-DynXX::Core::VM::LuaVM::LuaVM()
+DynXX::Core::VM::LuaVM::LuaVM(const std::string &cacheRoot) : chunkCacheDir(prepareCodeCacheDir(cacheRoot, "lua", LUA_RELEASE))
 {
-    this->lstate = luaL_newstate();
+    this->lstate = lua_newstate(LuaAllocator::alloc, &this->allocator);
+    lua_atpanic(this->lstate, _panic);
+    *static_cast<LuaVM **>(lua_getextraspace(this->lstate)) = this;
     luaL_openlibs(this->lstate);
 #if defined(USE_LIBUV)
-    lua_register_lib(this->lstate, "Timer", lib_timer_funcs);
-    _loop_init();
+    static constexpr luaL_Reg libTimerFuncs[] = {
+        {"add", lTimerAdd},
+        {"remove", lTimerRemove},
+        {nullptr, nullptr} /* sentinel */
+    };
+    lua_register_lib(this->lstate, "Timer", libTimerFuncs);
+    this->timerLoop = std::make_unique<TimerLoop>();
 #endif
 }
 
@@ -142,11 +315,31 @@ DynXX::Core::VM::LuaVM::~LuaVM()
 {
     this->active = false;
 #if defined(USE_LIBUV)
-    _loop_stop();
-#endif    
+    {
+        // Timers are released by the loop, the Lua refs are released with the state
+        auto lock = std::scoped_lock(this->vmMutex);
+        this->timers.clear();
+    }
+    this->timerLoop.reset();
+#endif
     lua_close(this->lstate);
 }
 
+void DynXX::Core::VM::LuaVM::setMemoryLimit(const size_t limit)
+{
+    this->allocator.setLimit(limit);
+}
+
+DynXXLuaMemoryStats DynXX::Core::VM::LuaVM::memoryStats() const
+{
+    return this->allocator.stats();
+}
+
+DynXX::Core::VM::LuaVM *DynXX::Core::VM::LuaVM::fromState(lua_State *L)
+{
+    return *static_cast<LuaVM **>(lua_getextraspace(L));
+}
+
 void DynXX::Core::VM::LuaVM::bindFunc(const std::string &funcName, int (*funcPointer)(lua_State *)) const {
     lua_register(this->lstate, funcName.c_str(), funcPointer);
 }
@@ -155,6 +348,18 @@ void DynXX::Core::VM::LuaVM::bindFunc(const std::string &funcName, int (*funcPoi
 bool DynXX::Core::VM::LuaVM::loadFile(const std::string &file)
 {
     auto lock = std::scoped_lock(this->vmMutex);
+    if (!this->chunkCacheDir.empty())
+    {
+        std::ifstream ifs(file.c_str());
+        if (!ifs.is_open()) [[unlikely]]
+        {
+            dynxxLogPrintF(DynXXLogLevelX::Error, "Can not open Lua file:{}", file);
+            return false;
+        }
+        std::ostringstream ss;
+        ss << ifs.rdbuf();
+        return this->loadScriptCached(ss.str(), "@" + file);
+    }
     if (const auto ret = luaL_dofile(this->lstate, file.c_str()); ret != LUA_OK) [[unlikely]]
     {
         PRINT_L_ERROR(this->lstate, "`luaL_dofile` error:");
@@ -167,6 +372,11 @@ bool DynXX::Core::VM::LuaVM::loadFile(const std::string &file)
 bool DynXX::Core::VM::LuaVM::loadScript(const std::string &script)
 {
     auto lock = std::scoped_lock(this->vmMutex);
+    if (!this->chunkCacheDir.empty())
+    {
+        // Same chunk name as `luaL_dostring`
+        return this->loadScriptCached(script, script);
+    }
     if (const auto ret = luaL_dostring(this->lstate, script.c_str()); ret != LUA_OK) [[unlikely]]
     {
         PRINT_L_ERROR(this->lstate, "`luaL_dostring` error:");
@@ -175,20 +385,92 @@ bool DynXX::Core::VM::LuaVM::loadScript(const std::string &script)
     return true;
 }
 
+bool DynXX::Core::VM::LuaVM::loadBinary(const Bytes &bytes)
+{
+    auto lock = std::scoped_lock(this->vmMutex);
+    return _loadChunk(this->lstate, reinterpret_cast<const char *>(bytes.data()), bytes.size(), "=binary", "b")
+           && _runChunk(this->lstate);
+}
+
+bool DynXX::Core::VM::LuaVM::loadScriptCached(const std::string &script, const std::string &chunkName)
+{
+    const auto path = _chunkCachePath(this->chunkCacheDir, script, chunkName);
+
+    if (const auto bytes = readCodeCache(path); !bytes.empty())
+    {
+        if (_loadChunk(this->lstate, reinterpret_cast<const char *>(bytes.data()), bytes.size(), chunkName, "b")) [[likely]]
+        {
+            return _runChunk(this->lstate);
+        }
+        // Broken cache, compile again to overwrite it
+        dynxxLogPrintF(DynXXLogLevelX::Warn, "Lua chunk cache read failed: {}", path);
+    }
+
+    if (!_loadChunk(this->lstate, script.data(), script.size(), chunkName, "t")) [[unlikely]]
+    {
+        return false;
+    }
+
+    Bytes chunk;
+    if (lua_dump(this->lstate, _chunkWriter, &chunk, 0) == 0 && !chunk.empty()) [[likely]]
+    {
+        writeCodeCache(path, chunk);
+    }
+    return _runChunk(this->lstate);
+}
+
 /// WARNING: Nested call between native and Lua requires a reenterable `recursive_mutex` here!
 std::optional<std::string> DynXX::Core::VM::LuaVM::callFunc(std::string_view func, std::string_view params)
 {
     auto lock = std::scoped_lock(this->vmMutex);
-    lua_getglobal(this->lstate, func.data());
-    lua_pushstring(this->lstate, params.data());
+    lua_getglobal(this->lstate, std::string(func).c_str());
+    return this->callTop(params);
+}
+
+std::optional<std::string> DynXX::Core::VM::LuaVM::callFunc(const FuncHandle handle, std::string_view params)
+{
+    auto lock = std::scoped_lock(this->vmMutex);
+    const auto it = this->pinnedFuncs.find(handle);
+    if (it == this->pinnedFuncs.end()) [[unlikely]]
+    {
+        dynxxLogPrintF(DynXXLogLevelX::Error, "Can not find Lua func handle:{}", handle);
+        return std::nullopt;
+    }
+    lua_rawgeti(this->lstate, LUA_REGISTRYINDEX, it->second);
+    return this->callTop(params);
+}
+
+bool DynXX::Core::VM::LuaVM::pinFunc(const FuncHandle handle, std::string_view func)
+{
+    auto lock = std::scoped_lock(this->vmMutex);
+    if (this->pinnedFuncs.contains(handle))
+    {
+        return true;
+    }
+    if (lua_getglobal(this->lstate, std::string(func).c_str()) != LUA_TFUNCTION) [[unlikely]]
+    {
+        lua_pop(this->lstate, 1);
+        dynxxLogPrintF(DynXXLogLevelX::Error, "Can not find Lua func:{}", func);
+        return false;
+    }
+    this->pinnedFuncs.emplace(handle, luaL_ref(this->lstate, LUA_REGISTRYINDEX));
+    return true;
+}
+
+std::optional<std::string> DynXX::Core::VM::LuaVM::callTop(std::string_view params)
+{
+    lua_pushlstring(this->lstate, params.data(), params.size());
     if (const auto ret = lua_pcall(this->lstate, 1, 1, 0); ret != LUA_OK) [[unlikely]]
     {
         PRINT_L_ERROR(this->lstate, "`lua_pcall` error:");
+        lua_pop(this->lstate, 1);
         return std::nullopt;
     }
-    const auto s = makeStr(lua_tostring(this->lstate, -1));
+    size_t len = 0;
+    const auto cS = lua_tolstring(this->lstate, -1, &len);
+    auto s = cS != nullptr ? std::string(cS, len) : std::string{};
 
     lua_pop(this->lstate, 1);
-    return {s};
+    return {std::move(s)};
 }
 #endif
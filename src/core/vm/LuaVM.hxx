@@ -11,9 +11,13 @@ EXTERN_C_END
 
 #if defined(__cplusplus)
 
+#include <memory>
+#include <unordered_map>
+
 #include <DynXX/CXX/Types.hxx>
 
 #include "BaseVM.hxx"
+#include "LuaAllocator.hxx"
 
 #define DEF_LUA_FUNC_VOID(fL, fS)           \
     int fL(lua_State *L)                    \
@@ -62,10 +66,14 @@ EXTERN_C_END
 namespace DynXX::Core::VM {
     class LuaVM final : public BaseVM {
     public:
+        /// Handle of a pinned Lua func, see `pinFunc`
+        using FuncHandle = size_t;
+
         /**
          * @brief Create Lua environment
+         * @param cacheRoot Root dir to cache the compiled chunks of loaded scripts, empty to disable the cache
          */
-        LuaVM();
+        explicit LuaVM(const std::string &cacheRoot = {});
 
         LuaVM(const LuaVM &) = delete;
 
@@ -75,6 +83,11 @@ namespace DynXX::Core::VM {
 
         LuaVM &operator=(LuaVM &&) = delete;
 
+        /**
+         * @brief Get the VM owning a Lua state (or a coroutine of it)
+         */
+        static LuaVM *fromState(lua_State *L);
+
         /**
          * @brief Load Lua file
          * @warning Will alert a prompt window in WebAssembly!
@@ -85,11 +98,19 @@ namespace DynXX::Core::VM {
 
         /**
          * @brief Load Lua script content
+         * @note With a chunk cache dir, the compiled chunk is cached by the hash of Lua version, chunk name & source.
          * @param script Lua script content
          * @return success or not
          */
         [[nodiscard]] bool loadScript(const std::string &script);
 
+        /**
+         * @brief Load precompiled Lua chunk, as dumped by `luac` or `string.dump`
+         * @param bytes Lua chunk
+         * @return success or not
+         */
+        [[nodiscard]] bool loadBinary(const Bytes &bytes);
+
         /**
          * @brief export C function to Lua environment
          * @param funcName the exported function name
@@ -105,14 +126,71 @@ namespace DynXX::Core::VM {
          */
         std::optional<std::string> callFunc(std::string_view func, std::string_view params);
 
+        /**
+         * @brief Pin a global Lua func by a registry ref, to call it later without looking it up by name
+         * @param handle Handle chosen by the caller, pinning the same handle again does nothing
+         * @param func Lua function name
+         * @return success or not
+         * @note The func is kept until the VM is released, even if the global is reassigned by scripts.
+         */
+        [[nodiscard]] bool pinFunc(FuncHandle handle, std::string_view func);
+
+        /**
+         * @brief Call Lua function pinned by `pinFunc`, see `callFunc` by name
+         */
+        std::optional<std::string> callFunc(FuncHandle handle, std::string_view params);
+
+        /**
+         * @brief Set the hard memory limit of the state
+         * @param limit Limit in bytes, `0` for no limit
+         * @note Takes effect on the next allocation, memory already used is not released.
+         */
+        void setMemoryLimit(size_t limit);
+
+        [[nodiscard]] DynXXLuaMemoryStats memoryStats() const;
+
         /**
          * @brief Release Lua environment
          */
         ~LuaVM() override;
 
     private:
+        // Declared before the state, so it outlives `lua_close`
+        LuaAllocator allocator;
         lua_State *lstate{nullptr};
-        std::unique_ptr<std::thread> threadTimer{nullptr};
+        const std::string chunkCacheDir;
+        /// Registry refs of pinned funcs, released with the state
+        std::unordered_map<FuncHandle, int> pinnedFuncs;
+
+        /**
+         * @brief Call the func on the top of the stack with `params`, must be called with `vmMutex` locked
+         */
+        std::optional<std::string> callTop(std::string_view params);
+
+        /**
+         * @brief Load Lua script through the chunk cache, must be called with `vmMutex` locked
+         */
+        bool loadScriptCached(const std::string &script, const std::string &chunkName);
+
+#if defined(USE_LIBUV)
+        struct Timer;
+        class TimerLoop;
+
+        /// Live timers by the ids returned to Lua, accessed with `vmMutex` locked
+        std::unordered_map<lua_Integer, Timer *> timers;
+        /// Ids are never reused, so a stale one can not remove another timer
+        lua_Integer nextTimerId{1};
+        std::unique_ptr<TimerLoop> timerLoop{nullptr};
+
+        /**
+         * @brief Run a timer callback on the loop thread, with `vmMutex` locked
+         */
+        void runTimer(Timer *timer);
+
+        static int lTimerAdd(lua_State *L);
+
+        static int lTimerRemove(lua_State *L);
+#endif
     };
 }
 
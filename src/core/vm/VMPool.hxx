@@ -0,0 +1,278 @@
+#ifndef DYNXX_SRC_CORE_VM_VMPOOL_HXX_
+#define DYNXX_SRC_CORE_VM_VMPOOL_HXX_
+
+#if defined(__cplusplus)
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <DynXX/CXX/Types.hxx>
+
+#include "../concurrent/ConcurrentUtil.hxx"
+
+namespace DynXX::Core::VM {
+
+    /**
+     * @brief A pool of isolated VMs loaded with the same scripts, calls are dispatched to them by `DynXXVMRoutingX`
+     * @note Checking out blocks only while the pool is resized: if all VMs are busy, the least busy one is shared,
+     * and calls on it are serialized by the VM itself.
+     */
+    template<typename VM>
+    class VMPool final {
+    public:
+        using CreateF = std::function<std::unique_ptr<VM>()>;
+        using LoadF = std::function<bool(VM &)>;
+
+        VMPool() = delete;
+
+        /**
+         * @brief Create a pool with one VM
+         * @param createF Create a VM with all the native funcs bound
+         */
+        explicit VMPool(CreateF &&createF) : createF(std::move(createF))
+        {
+            this->slots.emplace_back(std::make_unique<Slot>(this->createF()));
+        }
+
+        VMPool(const VMPool &) = delete;
+
+        VMPool &operator=(const VMPool &) = delete;
+
+        VMPool(VMPool &&) = delete;
+
+        VMPool &operator=(VMPool &&) = delete;
+
+        ~VMPool() = default;
+
+        /**
+         * @brief Resize the pool, new VMs load all the scripts loaded before
+         * @param size VM count, `0` to use the count of CPU cores
+         * @param routing How calls are dispatched
+         * @return Successful or not, the pool is left unchanged if failed
+         * @warning Waits for all VMs to be free, new checkouts wait meanwhile, do not call it from scripts.
+         */
+        bool resize(size_t size, const DynXXVMRoutingX routing)
+        {
+            if (size == 0)
+            {
+                size = std::max(Concurrent::countCPUCore(), 1u);
+            }
+            // No script is being loaded meanwhile, so the new VMs miss none
+            auto loadLock = std::scoped_lock(this->loadMutex);
+            auto lock = std::unique_lock(this->mutex);
+            // Hold new checkouts back, or steady calls would keep a VM busy forever
+            this->resizePending = true;
+            this->cv.wait(lock, [this] {
+                return std::ranges::none_of(this->slots, [](const auto &slot) { return slot->callCount > 0; });
+            });
+            auto res = false;
+            try
+            {
+                res = this->resizeLocked(size, routing);
+            }
+            catch (...)
+            {
+                this->endResize(lock);
+                throw;
+            }
+            this->endResize(lock);
+            return res;
+        }
+
+        /**
+         * @brief Load scripts into all VMs, and into VMs created later if loaded successfully in all VMs
+         * @return Successful in all VMs or not
+         */
+        bool load(LoadF &&loadF)
+        {
+            // Keep the order of scripts, without blocking checkouts while loading
+            auto loadLock = std::scoped_lock(this->loadMutex);
+            std::vector<Slot *> checkedOut;
+            {
+                auto lock = std::unique_lock(this->mutex);
+                checkedOut = this->checkoutAll(lock);
+            }
+            auto res = true;
+            auto f = [&loadF, &res](VM &vm) {
+                res = loadF(vm) && res;
+            };
+            this->forEachCheckedOut(checkedOut, f);
+            if (res)
+            {
+                // VMs created later load it by themselves, no resize can run before it is recorded
+                auto lock = std::scoped_lock(this->mutex);
+                this->loadFs.emplace_back(std::move(loadF));
+            }
+            return res;
+        }
+
+        /**
+         * @brief Run `f` with each VM of the pool, VMs are locked by themselves while being accessed
+         * @note The pool is not locked while running `f`, so a busy VM never blocks the others.
+         */
+        template<typename F>
+            requires std::invocable<F &, VM &>
+        void forEach(F &&f)
+        {
+            std::vector<Slot *> checkedOut;
+            {
+                auto lock = std::unique_lock(this->mutex);
+                checkedOut = this->checkoutAll(lock);
+            }
+            this->forEachCheckedOut(checkedOut, f);
+        }
+
+        /**
+         * @brief Check out a VM and run `f` with it
+         * @param f Function to run with the VM
+         * @return Return value of `f`
+         */
+        template<typename F>
+            requires std::invocable<F &, VM &>
+        std::invoke_result_t<F &, VM &> with(F &&f)
+        {
+            auto &slot = this->checkout();
+            try
+            {
+                auto res = f(*slot.vm);
+                this->checkin(slot);
+                return res;
+            }
+            catch (...)
+            {
+                this->checkin(slot);
+                throw;
+            }
+        }
+
+    private:
+        struct Slot {
+            std::unique_ptr<VM> vm;
+            size_t callCount{0};
+
+            explicit Slot(std::unique_ptr<VM> &&vm) : vm(std::move(vm))
+            {
+            }
+        };
+
+        CreateF createF;
+        std::vector<LoadF> loadFs;
+        // Slots are not moved on resizing, so the checked out ones stay valid
+        std::vector<std::unique_ptr<Slot>> slots;
+        DynXXVMRoutingX routing{DynXXVMRoutingX::AnyFree};
+        std::mutex mutex;
+        std::mutex loadMutex;
+        std::condition_variable cv;
+        bool resizePending{false};
+
+        /// Must be called with `mutex` locked and all VMs free
+        bool resizeLocked(const size_t size, const DynXXVMRoutingX routing)
+        {
+            std::vector<std::unique_ptr<Slot>> added;
+            while (this->slots.size() + added.size() < size)
+            {
+                auto vm = this->createF();
+                if (!vm) [[unlikely]]
+                {
+                    return false;
+                }
+                for (auto &loadF : this->loadFs)
+                {
+                    if (!loadF(*vm)) [[unlikely]]
+                    {
+                        return false;
+                    }
+                }
+                added.emplace_back(std::make_unique<Slot>(std::move(vm)));
+            }
+            this->routing = routing;
+            while (this->slots.size() > size)
+            {
+                this->slots.pop_back();
+            }
+            std::ranges::move(added, std::back_inserter(this->slots));
+            return true;
+        }
+
+        void endResize(std::unique_lock<std::mutex> &lock)
+        {
+            this->resizePending = false;
+            lock.unlock();
+            this->cv.notify_all();
+        }
+
+        /// Waits for a pending resize, the VMs are kept until checked in, even if the pool is resized
+        std::vector<Slot *> checkoutAll(std::unique_lock<std::mutex> &lock)
+        {
+            this->cv.wait(lock, [this] { return !this->resizePending; });
+            std::vector<Slot *> checkedOut;
+            checkedOut.reserve(this->slots.size());
+            for (const auto &slot : this->slots)
+            {
+                slot->callCount++;
+                checkedOut.emplace_back(slot.get());
+            }
+            return checkedOut;
+        }
+
+        template<typename F>
+        void forEachCheckedOut(const std::vector<Slot *> &checkedOut, F &f)
+        {
+            auto i = 0uz;
+            try
+            {
+                for (; i < checkedOut.size(); i++)
+                {
+                    f(*checkedOut[i]->vm);
+                    this->checkin(*checkedOut[i]);
+                }
+            }
+            catch (...)
+            {
+                for (; i < checkedOut.size(); i++)
+                {
+                    this->checkin(*checkedOut[i]);
+                }
+                throw;
+            }
+        }
+
+        Slot &checkout()
+        {
+            auto lock = std::unique_lock(this->mutex);
+            this->cv.wait(lock, [this] { return !this->resizePending; });
+            auto &slot = this->pick();
+            slot.callCount++;
+            return slot;
+        }
+
+        void checkin(Slot &slot)
+        {
+            {
+                auto lock = std::scoped_lock(this->mutex);
+                slot.callCount--;
+            }
+            this->cv.notify_all();
+        }
+
+        /// Must be called with `mutex` locked
+        Slot &pick()
+        {
+            if (this->routing == DynXXVMRoutingX::Sticky)
+            {
+                return *this->slots[std::hash<std::thread::id>{}(std::this_thread::get_id()) % this->slots.size()];
+            }
+            return **std::ranges::min_element(this->slots, {}, [](const auto &slot) { return slot->callCount; });
+        }
+    };
+}
+
+#endif
+
+#endif // DYNXX_SRC_CORE_VM_VMPOOL_HXX_
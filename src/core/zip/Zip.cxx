@@ -19,7 +19,7 @@
 namespace {
     template<typename T>
     concept ReadBytesFuncT = requires(T f) {
-        { f() } -> std::convertible_to<Bytes>;
+        { f() } -> std::convertible_to<BytesView>;
     };
 
     template<typename T>
@@ -111,15 +111,16 @@ namespace {
 #endif
 
     template <typename T>
-    Bytes processBytes(size_t bufferSize, const Bytes &in, DynXX::Core::Z::ZBase<T> &zb)
+    Bytes processBytes(size_t bufferSize, BytesView in, DynXX::Core::Z::ZBase<T> &zb)
     {
-        long pos(0);
+        size_t pos(0);
         Bytes outBytes;
         auto b = process(zb, bufferSize,
-            [bufferSize, &in, &pos]
+            [bufferSize, in, &pos]
             {
-                const auto len = static_cast<long>(std::min<size_t>(bufferSize, in.size() - pos));
-                Bytes bytes(in.begin() + pos, in.begin() + pos + len);
+                // Input chunks are views of `in`, they are copied only into the z_stream buffer
+                const auto len = std::min<size_t>(bufferSize, in.size() - pos);
+                const auto bytes = in.subspan(pos, len);
                 pos += len;
                 return bytes;
             },
@@ -166,7 +167,7 @@ DynXX::Core::Z::ZBase<T>::ZBase(size_t bufferSize, int format) : bufferSize{buff
 }
 
 template <typename T>
-size_t DynXX::Core::Z::ZBase<T>::input(const Bytes &bytes, bool finish)
+size_t DynXX::Core::Z::ZBase<T>::input(BytesView bytes, bool finish)
 {
     if (bytes.empty()) [[unlikely]]
     {
@@ -299,14 +300,28 @@ bool DynXX::Core::Z::unzip(size_t bufferSize, int format, std::FILE *inFile, std
 
 // Bytes
 
-Bytes DynXX::Core::Z::zip(int mode, size_t bufferSize, int format, const Bytes &bytes)
+Bytes DynXX::Core::Z::zip(int mode, size_t bufferSize, int format, BytesView bytes)
 {
     Zip zip(mode, bufferSize, format);
     return processBytes(bufferSize, bytes, zip);
 }
 
-Bytes DynXX::Core::Z::unzip(size_t bufferSize, int format, const Bytes &bytes)
+Bytes DynXX::Core::Z::unzip(size_t bufferSize, int format, BytesView bytes)
 {
     UnZip unzip(bufferSize, format);
     return processBytes(bufferSize, bytes, unzip);
-}
\ No newline at end of file
+}
+
+DynXX::Core::Concurrent::Task<Bytes> DynXX::Core::Z::zipAsync(Concurrent::Executor &executor, int mode, size_t bufferSize, int format, Bytes bytes)
+{
+    co_return co_await Concurrent::blockingAsync(executor, [&] {
+        return zip(mode, bufferSize, format, bytes);
+    }, Concurrent::TaskPriority::Low);
+}
+
+DynXX::Core::Concurrent::Task<Bytes> DynXX::Core::Z::unzipAsync(Concurrent::Executor &executor, size_t bufferSize, int format, Bytes bytes)
+{
+    co_return co_await Concurrent::blockingAsync(executor, [&] {
+        return unzip(bufferSize, format, bytes);
+    }, Concurrent::TaskPriority::Low);
+}
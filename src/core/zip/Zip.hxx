@@ -10,6 +10,8 @@
 
 #include <DynXX/CXX/Types.hxx>
 
+#include "../concurrent/Task.hxx"
+
 namespace DynXX::Core::Z {
     template<typename T>
     class ZBase {
@@ -28,7 +30,7 @@ namespace DynXX::Core::Z {
 
         virtual ~ZBase();
 
-        size_t input(const Bytes &bytes, bool finish);
+        size_t input(BytesView bytes, bool finish);
 
         Bytes processDo();
 
@@ -104,9 +106,21 @@ namespace DynXX::Core::Z {
 
 #endif
 
-    Bytes zip(int mode, size_t bufferSize, int format, const Bytes &bytes);
+    Bytes zip(int mode, size_t bufferSize, int format, BytesView bytes);
+
+    Bytes unzip(size_t bufferSize, int format, BytesView bytes);
+
+    /**
+     * @brief Awaitable version of `zip()`, runs on a worker of `Executor::blockingIO()`,
+     * then resumes on `executor` as a `Low` priority task
+     */
+    Concurrent::Task<Bytes> zipAsync(Concurrent::Executor &executor, int mode, size_t bufferSize, int format, Bytes bytes);
 
-    Bytes unzip(size_t bufferSize, int format, const Bytes &bytes);
+    /**
+     * @brief Awaitable version of `unzip()`, runs on a worker of `Executor::blockingIO()`,
+     * then resumes on `executor` as a `Low` priority task
+     */
+    Concurrent::Task<Bytes> unzipAsync(Concurrent::Executor &executor, size_t bufferSize, int format, Bytes bytes);
 }
 
 #endif
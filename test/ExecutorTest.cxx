@@ -0,0 +1,204 @@
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "core/concurrent/Executor.hxx"
+
+#include "TestUtil.hxx"
+
+using namespace DynXX::Core::Concurrent;
+using DynXX::Test::waitUntil;
+
+namespace
+{
+    void testRunAll()
+    {
+        constexpr auto taskCount = 10'000uz;
+        Executor executor(ExecutorConfig{.minWorkerCount = 2, .maxWorkerCount = 4, .workStealing = true});
+        std::atomic<size_t> done{0};
+        for (auto i = 0uz; i < taskCount; i++)
+        {
+            executor >> [&done] { done.fetch_add(1); };
+        }
+        auto future = executor.submit([] { return 42; }, TaskPriority::High);
+        DYNXX_CHECK(future.get() == 42);
+        DYNXX_CHECK(waitUntil([&done] { return done.load() == taskCount; }));
+        DYNXX_CHECK(executor.stats().submittedCount == taskCount + 1);
+    }
+
+    /// Jobs queued behind a blocked worker are stolen by the idle one, never left waiting
+    void testStealingNeverStalls()
+    {
+        Executor executor(ExecutorConfig{.minWorkerCount = 2, .maxWorkerCount = 2, .workStealing = true});
+        for (auto round = 0; round < 200; round++)
+        {
+            std::promise<void> release;
+            std::atomic<bool> blocking{false};
+            executor >> [&blocking, blocked = release.get_future().share()] {
+                blocking = true;
+                blocked.wait();
+            };
+            DYNXX_CHECK(waitUntil([&blocking] { return blocking.load(); }));
+            std::atomic<size_t> done{0};
+            for (auto i = 0; i < 8; i++)
+            {
+                executor >> [&done] { done.fetch_add(1); };
+            }
+            DYNXX_CHECK(waitUntil([&done] { return done.load() == 8; }, std::chrono::seconds(10)));
+            release.set_value();
+        }
+        DYNXX_CHECK(waitUntil([&executor] { return executor.stats().total.executedCount == 200 * 9; }));
+    }
+
+    void testBatchAndPriorities()
+    {
+        constexpr auto taskCount = 1'000uz;
+        Executor executor(ExecutorConfig{.minWorkerCount = 1, .maxWorkerCount = 3});
+        std::atomic<size_t> done{0};
+        std::vector<TaskT> tasks;
+        for (auto i = 0uz; i < taskCount; i++)
+        {
+            tasks.emplace_back([&done] { done.fetch_add(1); });
+        }
+        executor.submitBatch(tasks, TaskPriority::Low);
+        std::vector<Job> jobs;
+        for (auto i = 0uz; i < taskCount; i++)
+        {
+            jobs.emplace_back(Job{.task = [&done] { done.fetch_add(1); }, .priority = static_cast<TaskPriority>(i % TaskPriorityCount)});
+        }
+        executor.submitBatch(jobs);
+        DYNXX_CHECK(waitUntil([&done] { return done.load() == taskCount * 2; }));
+    }
+
+    void testDeadline()
+    {
+        Executor executor(ExecutorConfig{.minWorkerCount = 1, .maxWorkerCount = 1});
+        std::promise<void> release;
+        executor >> [blocked = release.get_future().share()] { blocked.wait(); };
+        std::atomic<bool> ran{false};
+        std::atomic<bool> expired{false};
+        executor >> Job{
+            .task = [&ran] { ran = true; },
+            .deadline = TaskClock::now() + std::chrono::milliseconds(1),
+            .onExpired = [&expired] { expired = true; }
+        };
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        release.set_value();
+        DYNXX_CHECK(waitUntil([&expired] { return expired.load(); }));
+        DYNXX_CHECK(!ran.load());
+        DYNXX_CHECK(executor.stats().total.expiredCount == 1);
+    }
+
+    /// The reserved worker outlives the idle timeout while a `Low` task holds the other one
+    void testReservedWorkerKept()
+    {
+        Executor executor(ExecutorConfig{.minWorkerCount = 0, .maxWorkerCount = 2, .idleTimeoutMicroSecs = 2'000});
+        std::promise<void> release;
+        std::atomic<bool> blocking{false};
+        executor >> Job{
+            .task = [&blocking, blocked = release.get_future().share()] {
+                blocking = true;
+                blocked.wait();
+            },
+            .priority = TaskPriority::Low
+        };
+        DYNXX_CHECK(waitUntil([&blocking] { return blocking.load(); }));
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        DYNXX_CHECK(executor.stats().workerCount == 2);
+        std::atomic<bool> ran{false};
+        executor >> Job{.task = [&ran] { ran = true; }, .priority = TaskPriority::High};
+        DYNXX_CHECK(waitUntil([&ran] { return ran.load(); }, std::chrono::seconds(5)));
+        release.set_value();
+    }
+
+    /// Pending tasks are released with the Executor, their futures are broken instead of hanging
+    void testShutdownWithPending()
+    {
+        constexpr auto taskCount = 1'000uz;
+        const auto token = std::make_shared<int>(0);
+        std::vector<Future<size_t>> futures;
+        std::atomic<size_t> ran{0};
+        {
+            Executor executor(ExecutorConfig{.minWorkerCount = 1, .maxWorkerCount = 1});
+            executor >> [] { std::this_thread::sleep_for(std::chrono::milliseconds(50)); };
+            for (auto i = 0uz; i < taskCount; i++)
+            {
+                futures.emplace_back(executor.submit([token, &ran, i] {
+                    ran.fetch_add(1);
+                    return i;
+                }));
+            }
+        }
+        DYNXX_CHECK(token.use_count() == 1);
+        auto broken = 0uz;
+        for (auto i = 0uz; i < taskCount; i++)
+        {
+            DYNXX_CHECK(futures[i].ready());
+            try
+            {
+                DYNXX_CHECK(futures[i].get() == i);
+            }
+            catch (const std::future_error &e)
+            {
+                DYNXX_CHECK(e.code() == std::future_errc::broken_promise);
+                broken++;
+            }
+        }
+        DYNXX_CHECK(ran.load() + broken == taskCount);
+    }
+
+    /// Idle workers retire, and are created again on demand
+    void testIdleRetire()
+    {
+        Executor executor(ExecutorConfig{.minWorkerCount = 0, .maxWorkerCount = 4, .idleTimeoutMicroSecs = 2'000, .workStealing = true});
+        for (auto round = 0; round < 2; round++)
+        {
+            std::atomic<size_t> done{0};
+            for (auto i = 0; i < 100; i++)
+            {
+                executor >> [&done] {
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+                    done.fetch_add(1);
+                };
+            }
+            DYNXX_CHECK(waitUntil([&done] { return done.load() == 100; }));
+            DYNXX_CHECK(waitUntil([&executor] { return executor.stats().workerCount == 0; }));
+        }
+        const auto stats = executor.stats();
+        DYNXX_CHECK(stats.retiredWorkerCount == stats.createdWorkerCount);
+    }
+
+    /// Executors torn down while busy, stealing and retiring
+    void testRepeatedShutdown()
+    {
+        for (auto round = 0; round < 50; round++)
+        {
+            std::atomic<size_t> done{0};
+            {
+                Executor executor(ExecutorConfig{.minWorkerCount = 1, .maxWorkerCount = 4, .idleTimeoutMicroSecs = 100, .workStealing = true});
+                for (auto i = 0; i < 200; i++)
+                {
+                    executor >> Job{.task = [&done] { done.fetch_add(1); }, .priority = static_cast<TaskPriority>(i % TaskPriorityCount)};
+                }
+            }
+            DYNXX_CHECK(done.load() <= 200);
+        }
+    }
+}
+
+int main()
+{
+    DynXX::Test::run("run all", testRunAll);
+    DynXX::Test::run("stealing never stalls", testStealingNeverStalls);
+    DynXX::Test::run("batch & priorities", testBatchAndPriorities);
+    DynXX::Test::run("deadline", testDeadline);
+    DynXX::Test::run("reserved worker kept", testReservedWorkerKept);
+    DynXX::Test::run("shutdown with pending tasks", testShutdownWithPending);
+    DynXX::Test::run("idle retire", testIdleRetire);
+    DynXX::Test::run("repeated shutdown", testRepeatedShutdown);
+    return EXIT_SUCCESS;
+}
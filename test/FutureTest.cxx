@@ -0,0 +1,122 @@
+#include <future>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "core/concurrent/Executor.hxx"
+#include "core/concurrent/Future.hxx"
+#include "core/concurrent/Task.hxx"
+
+#include "TestUtil.hxx"
+
+using namespace DynXX::Core::Concurrent;
+
+namespace
+{
+    void testThen()
+    {
+        Promise<int> fulfilledLater;
+        auto later = fulfilledLater.future().then([](int v) { return v * 2; }).then([](int v) { return v + 1; });
+        DYNXX_CHECK(!later.ready());
+        std::thread t([p = std::move(fulfilledLater)]() mutable { p.set(20); });
+        DYNXX_CHECK(later.get() == 41);
+        t.join();
+
+        Promise<int> fulfilledBefore;
+        fulfilledBefore.set(1);
+        auto before = fulfilledBefore.future().then([](int v) { return v + 1; });
+        DYNXX_CHECK(before.ready() && before.get() == 2);
+    }
+
+    void testExceptions()
+    {
+        Promise<int> p;
+        auto f = p.future().then([](int) -> int { throw std::runtime_error("step"); }).then([](int v) { return v; });
+        p.set(1);
+        DYNXX_CHECK_THROWS(f.get(), std::runtime_error);
+
+        std::optional<Future<int>> broken;
+        {
+            Promise<int> dropped;
+            auto copy = dropped;
+            broken.emplace(dropped.future());
+            dropped = Promise<int>{};
+            DYNXX_CHECK(!broken->ready());
+        }
+        DYNXX_CHECK_THROWS(broken->get(), std::future_error);
+    }
+
+    Task<size_t> chain(Executor &executor, const size_t depth)
+    {
+        if (depth == 0)
+        {
+            co_return co_await async(executor, [] { return 0uz; });
+        }
+        co_return co_await chain(executor, depth - 1) + 1;
+    }
+
+    Task<int> failing(Executor &executor)
+    {
+        co_await schedule(executor);
+        throw std::runtime_error("task");
+    }
+
+    void testTask()
+    {
+        Executor executor(ExecutorConfig{.minWorkerCount = 2, .maxWorkerCount = 2});
+        DYNXX_CHECK(spawn(chain(executor, 1'000)).get() == 1'000);
+
+        std::vector<Future<size_t>> futures;
+        for (auto i = 0uz; i < 100; i++)
+        {
+            futures.emplace_back(spawn(chain(executor, i)));
+        }
+        for (auto i = 0uz; i < futures.size(); i++)
+        {
+            DYNXX_CHECK(futures[i].get() == i);
+        }
+
+        DYNXX_CHECK_THROWS(spawn(failing(executor)).get(), std::runtime_error);
+    }
+
+    Task<std::thread::id> blockingThenResume(Executor &executor, std::shared_future<void> blocked)
+    {
+        // Not a temporary in the co_await expression, GCC 12 destroys those twice
+        auto wait = [blocked] { blocked.wait(); };
+        co_await blockingAsync(executor, std::move(wait));
+        co_return std::this_thread::get_id();
+    }
+
+    /// Blocking calls hold no worker of the awaiting Executor, and resume on it
+    void testBlockingAsync()
+    {
+        Executor executor(ExecutorConfig{.minWorkerCount = 1, .maxWorkerCount = 1});
+        const auto workerId = executor.submit([] { return std::this_thread::get_id(); }).get();
+
+        std::promise<void> release;
+        const auto blocked = release.get_future().share();
+        std::vector<Future<std::thread::id>> futures;
+        for (auto i = 0; i < 4; i++)
+        {
+            futures.emplace_back(spawn(blockingThenResume(executor, blocked)));
+        }
+        DYNXX_CHECK(executor.submit([] { return 1; }).get() == 1);
+        release.set_value();
+        for (auto &f : futures)
+        {
+            DYNXX_CHECK(f.get() == workerId);
+        }
+
+        DYNXX_CHECK_THROWS(spawn(blockingAsync(executor, []() -> int { throw std::runtime_error("io"); })).get(), std::runtime_error);
+    }
+}
+
+int main()
+{
+    DynXX::Test::run("then", testThen);
+    DynXX::Test::run("exceptions & broken promise", testExceptions);
+    DynXX::Test::run("Task", testTask);
+    DynXX::Test::run("blockingAsync", testBlockingAsync);
+    return EXIT_SUCCESS;
+}
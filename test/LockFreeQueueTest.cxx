@@ -0,0 +1,109 @@
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "core/concurrent/LockFreeQueue.hxx"
+
+#include "TestUtil.hxx"
+
+using namespace DynXX::Core::Concurrent;
+
+namespace
+{
+    void testFifoAndCapacity()
+    {
+        BoundedMPMCQueue<int> q{3};
+        for (auto i = 0; i < 4; i++)
+        {
+            DYNXX_CHECK(q.tryPush(int{i}));
+        }
+        auto v = 42;
+        DYNXX_CHECK(!q.tryPush(std::move(v)));
+        DYNXX_CHECK(v == 42);
+        DYNXX_CHECK(q.sizeApprox() == 4);
+        for (auto i = 0; i < 4; i++)
+        {
+            DYNXX_CHECK(q.tryPop(v));
+            DYNXX_CHECK(v == i);
+        }
+        DYNXX_CHECK(!q.tryPop(v));
+        DYNXX_CHECK(q.sizeApprox() == 0);
+    }
+
+    /// Elements left in the queue are released with it
+    void testMoveOnly()
+    {
+        BoundedMPMCQueue<std::unique_ptr<int>> q{8};
+        for (auto i = 0; i < 5; i++)
+        {
+            DYNXX_CHECK(q.tryPush(std::make_unique<int>(i)));
+        }
+        std::unique_ptr<int> p;
+        DYNXX_CHECK(q.tryPop(p));
+        DYNXX_CHECK(p && *p == 0);
+    }
+
+    /// Every element is popped exactly once, and in order per producer
+    void testMPMC()
+    {
+        constexpr auto producerCount = 4uz;
+        constexpr auto consumerCount = 4uz;
+        constexpr auto perProducer = 100'000uz;
+        BoundedMPMCQueue<uint64_t> q{64};
+        std::vector<std::atomic<uint8_t>> seen(producerCount * perProducer);
+        std::atomic<size_t> popped{0};
+
+        std::vector<std::thread> threads;
+        for (auto p = 0uz; p < producerCount; p++)
+        {
+            threads.emplace_back([&q, p] {
+                for (auto i = 0uz; i < perProducer; i++)
+                {
+                    auto v = static_cast<uint64_t>(p << 32 | i);
+                    while (!q.tryPush(std::move(v)))
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for (auto c = 0uz; c < consumerCount; c++)
+        {
+            threads.emplace_back([&] {
+                std::vector<int64_t> last(producerCount, -1);
+                uint64_t v;
+                while (popped.load(std::memory_order_relaxed) < producerCount * perProducer)
+                {
+                    if (!q.tryPop(v))
+                    {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    const auto p = v >> 32;
+                    const auto i = static_cast<int64_t>(v & 0xFFFFFFFFu);
+                    DYNXX_CHECK(p < producerCount && i > last[p]);
+                    last[p] = i;
+                    DYNXX_CHECK(seen[p * perProducer + i].fetch_add(1) == 0);
+                    popped.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+        }
+        for (auto &t : threads)
+        {
+            t.join();
+        }
+        DYNXX_CHECK(popped.load() == producerCount * perProducer);
+        uint64_t v;
+        DYNXX_CHECK(!q.tryPop(v));
+    }
+}
+
+int main()
+{
+    DynXX::Test::run("FIFO & capacity", testFifoAndCapacity);
+    DynXX::Test::run("move-only elements", testMoveOnly);
+    DynXX::Test::run("MPMC", testMPMC);
+    return EXIT_SUCCESS;
+}
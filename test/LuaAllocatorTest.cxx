@@ -0,0 +1,131 @@
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "core/vm/LuaAllocator.hxx"
+
+#include "TestUtil.hxx"
+
+using DynXX::Core::VM::LuaAllocator;
+
+namespace
+{
+    struct Block {
+        unsigned char *p;
+        size_t size;
+        unsigned char fill;
+    };
+
+    void checkFilled(const Block &b, const size_t size)
+    {
+        for (auto i = 0uz; i < size; i++)
+        {
+            DYNXX_CHECK(b.p[i] == b.fill);
+        }
+    }
+
+    /// Random alloc/realloc/free as a `lua_State` does, contents must survive moves between size classes
+    void testRandomOps(const size_t limit)
+    {
+        LuaAllocator allocator;
+        allocator.setLimit(limit);
+        std::mt19937 rng(limit);
+        const auto randomSize = [&rng] { return rng() % 4 == 0 ? 1 + rng() % 4'000 : 1 + rng() % 256; };
+        std::vector<Block> blocks;
+        for (auto i = 0; i < 200'000; i++)
+        {
+            const auto op = rng() % 3;
+            if (op == 0 || blocks.empty())
+            {
+                const auto size = randomSize();
+                const auto p = static_cast<unsigned char *>(LuaAllocator::alloc(&allocator, nullptr, 0, size));
+                if (p == nullptr)
+                {
+                    DYNXX_CHECK(limit > 0);
+                    continue;
+                }
+                const auto fill = static_cast<unsigned char>(rng());
+                std::memset(p, fill, size);
+                blocks.emplace_back(Block{p, size, fill});
+            }
+            else if (op == 1)
+            {
+                auto &b = blocks[rng() % blocks.size()];
+                const auto size = randomSize();
+                const auto p = static_cast<unsigned char *>(LuaAllocator::alloc(&allocator, b.p, b.size, size));
+                if (p == nullptr)
+                {
+                    // Only growing may fail
+                    DYNXX_CHECK(limit > 0 && size > b.size);
+                    continue;
+                }
+                b.p = p;
+                checkFilled(b, std::min(b.size, size));
+                b.size = size;
+                std::memset(p, b.fill, size);
+            }
+            else
+            {
+                const auto pos = rng() % blocks.size();
+                checkFilled(blocks[pos], blocks[pos].size);
+                DYNXX_CHECK(LuaAllocator::alloc(&allocator, blocks[pos].p, blocks[pos].size, 0) == nullptr);
+                blocks[pos] = blocks.back();
+                blocks.pop_back();
+            }
+        }
+        const auto stats = allocator.stats();
+        DYNXX_CHECK(limit == 0 || static_cast<size_t>(stats.arenaSize) <= limit);
+        for (const auto &b : blocks)
+        {
+            LuaAllocator::alloc(&allocator, b.p, b.size, 0);
+        }
+        DYNXX_CHECK(allocator.stats().usedSize == 0);
+    }
+
+    void testSlabsReturned()
+    {
+        LuaAllocator allocator;
+        std::vector<void *> blocks;
+        for (auto i = 0; i < 100'000; i++)
+        {
+            blocks.emplace_back(LuaAllocator::alloc(&allocator, nullptr, 0, 32));
+        }
+        const auto peakArena = allocator.stats().arenaSize;
+        for (const auto p : blocks)
+        {
+            LuaAllocator::alloc(&allocator, p, 32, 0);
+        }
+        // Only one slab per size class is kept
+        DYNXX_CHECK(allocator.stats().arenaSize < peakArena);
+        DYNXX_CHECK(allocator.stats().arenaSize <= 64 * 1024);
+    }
+
+    /// A shrink never fails, even if the block can not be moved
+    void testShrinkBeyondLimit()
+    {
+        LuaAllocator allocator;
+        allocator.setLimit(8 * 1024);
+        const auto p = LuaAllocator::alloc(&allocator, nullptr, 0, 4'000);
+        DYNXX_CHECK(p != nullptr);
+        std::memset(p, 7, 4'000);
+        // No slab fits in the limit, so the large block is kept
+        DYNXX_CHECK(LuaAllocator::alloc(&allocator, p, 4'000, 100) == p);
+        DYNXX_CHECK(LuaAllocator::alloc(&allocator, p, 100, 50) == p);
+        const auto q = static_cast<unsigned char *>(LuaAllocator::alloc(&allocator, p, 50, 3'000));
+        DYNXX_CHECK(q != nullptr && q[49] == 7);
+        DYNXX_CHECK(LuaAllocator::alloc(&allocator, q, 3'000, 10) == q);
+        LuaAllocator::alloc(&allocator, q, 10, 0);
+        DYNXX_CHECK(allocator.stats().usedSize == 0);
+        // Still tracked when the allocator goes away
+        DYNXX_CHECK(LuaAllocator::alloc(&allocator, LuaAllocator::alloc(&allocator, nullptr, 0, 5'000), 5'000, 20) != nullptr);
+    }
+}
+
+int main()
+{
+    DynXX::Test::run("random ops", [] { testRandomOps(0); });
+    DynXX::Test::run("random ops with limit", [] { testRandomOps(600 * 1024); });
+    DynXX::Test::run("slabs returned", testSlabsReturned);
+    DynXX::Test::run("shrink beyond limit", testShrinkBeyondLimit);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,81 @@
+#include <atomic>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "core/concurrent/Executor.hxx"
+#include "core/concurrent/Parallel.hxx"
+
+#include "TestUtil.hxx"
+
+using namespace DynXX::Core::Concurrent;
+
+namespace
+{
+    void testParallel()
+    {
+        Executor executor(ExecutorConfig{.minWorkerCount = 3, .maxWorkerCount = 3});
+        std::vector<size_t> values(1'000'000);
+        std::iota(values.begin(), values.end(), 0uz);
+
+        std::vector<std::atomic<uint8_t>> visited(values.size());
+        parallelFor(executor, 0, values.size(), [&visited](const size_t begin, const size_t end) {
+            for (auto i = begin; i < end; i++)
+            {
+                visited[i].fetch_add(1);
+            }
+        }, 1'000);
+        for (const auto &v : visited)
+        {
+            DYNXX_CHECK(v.load() == 1);
+        }
+
+        const auto sum = parallelReduce(executor, 0, values.size(), 0uz, [&values](const size_t begin, const size_t end) {
+            return std::accumulate(values.begin() + begin, values.begin() + end, 0uz);
+        }, [](const size_t a, const size_t b) { return a + b; });
+        DYNXX_CHECK(sum == values.size() * (values.size() - 1) / 2);
+    }
+
+    /// A throwing chunk fails the whole call on the caller, only after no chunk is running anymore
+    void testParallelException()
+    {
+        Executor executor(ExecutorConfig{.minWorkerCount = 3, .maxWorkerCount = 3});
+        for (auto round = 0; round < 100; round++)
+        {
+            std::atomic<size_t> running{0};
+            DYNXX_CHECK_THROWS(parallelFor(executor, 0, 1'000, [&running](const size_t begin, size_t) {
+                running.fetch_add(1);
+                std::this_thread::yield();
+                running.fetch_sub(1);
+                if (begin == 500)
+                {
+                    throw std::runtime_error("chunk");
+                }
+            }, 10), std::runtime_error);
+            DYNXX_CHECK(running.load() == 0);
+        }
+
+        DYNXX_CHECK_THROWS(parallelFor(executor, 0, 10, [](size_t, size_t) {
+            throw std::runtime_error("inline");
+        }), std::runtime_error);
+
+        DYNXX_CHECK_THROWS(parallelReduce(executor, 0, 1'000, 0uz, [](const size_t begin, size_t) -> size_t {
+            if (begin == 0)
+            {
+                throw std::out_of_range("map");
+            }
+            return begin;
+        }, [](const size_t a, const size_t b) { return a + b; }, 100), std::out_of_range);
+
+        DYNXX_CHECK(executor.submit([] { return 1; }).get() == 1);
+    }
+}
+
+int main()
+{
+    DynXX::Test::run("parallelFor & parallelReduce", testParallel);
+    DynXX::Test::run("exception in chunk", testParallelException);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,114 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "core/concurrent/Lock.hxx"
+
+#include "TestUtil.hxx"
+
+using namespace DynXX::Core::Concurrent;
+
+namespace
+{
+    void testPermit()
+    {
+        Parker parker;
+        parker.unpark();
+        parker.unpark();
+        // Consumes the single permit, so the next `parkFor` waits for its timeout
+        parker.park();
+        const auto begin = std::chrono::steady_clock::now();
+        parker.parkFor(1000);
+        DYNXX_CHECK(std::chrono::steady_clock::now() - begin < std::chrono::seconds(10));
+    }
+
+    /// No wakeup is lost between a producer publishing and the consumer parking
+    void testNoLostWakeup()
+    {
+        constexpr auto rounds = 20'000uz;
+        Parker parker;
+        std::atomic<size_t> produced{0};
+        std::thread producer([&] {
+            for (auto i = 0uz; i < rounds; i++)
+            {
+                produced.fetch_add(1, std::memory_order_release);
+                parker.unpark();
+            }
+        });
+        auto consumed = 0uz;
+        while (consumed < rounds)
+        {
+            if (const auto n = produced.load(std::memory_order_acquire); n > consumed)
+            {
+                consumed = n;
+                continue;
+            }
+            parker.park();
+        }
+        producer.join();
+    }
+
+    void testPingPong()
+    {
+        constexpr auto rounds = 10'000uz;
+        Parker ping;
+        Parker pong;
+        std::atomic<size_t> turn{0};
+        std::thread t([&] {
+            for (auto i = 0uz; i < rounds; i++)
+            {
+                while (turn.load(std::memory_order_acquire) != i * 2 + 1)
+                {
+                    ping.park();
+                }
+                turn.store(i * 2 + 2, std::memory_order_release);
+                pong.unpark();
+            }
+        });
+        for (auto i = 0uz; i < rounds; i++)
+        {
+            turn.store(i * 2 + 1, std::memory_order_release);
+            ping.unpark();
+            while (turn.load(std::memory_order_acquire) != i * 2 + 2)
+            {
+                pong.park();
+            }
+        }
+        t.join();
+    }
+
+    void testSpinLock()
+    {
+        constexpr auto threadCount = 4uz;
+        constexpr auto perThread = 50'000uz;
+        SpinLock lock;
+        auto counter = 0uz;
+        std::vector<std::thread> threads;
+        for (auto i = 0uz; i < threadCount; i++)
+        {
+            threads.emplace_back([&] {
+                for (auto j = 0uz; j < perThread; j++)
+                {
+                    lock.lock();
+                    counter++;
+                    lock.unlock();
+                }
+            });
+        }
+        for (auto &t : threads)
+        {
+            t.join();
+        }
+        DYNXX_CHECK(counter == threadCount * perThread);
+    }
+}
+
+int main()
+{
+    DynXX::Test::run("permit", testPermit);
+    DynXX::Test::run("no lost wakeup", testNoLostWakeup);
+    DynXX::Test::run("ping-pong", testPingPong);
+    DynXX::Test::run("SpinLock", testSpinLock);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,60 @@
+#ifndef DYNXX_TEST_TESTUTIL_HXX_
+#define DYNXX_TEST_TESTUTIL_HXX_
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+/// Fail the test with the location of the broken condition, kept in Release builds
+#define DYNXX_CHECK(cond)                                                      \
+  do {                                                                         \
+    if (!(cond)) [[unlikely]] {                                                \
+      std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__,    \
+                   #cond);                                                     \
+      std::exit(EXIT_FAILURE);                                                 \
+    }                                                                          \
+  } while (false)
+
+/// Fail the test unless `expr` throws `E`
+#define DYNXX_CHECK_THROWS(expr, E)                                            \
+  do {                                                                         \
+    auto thrown = false;                                                       \
+    try {                                                                      \
+      (void)(expr);                                                            \
+    } catch (const E &) {                                                      \
+      thrown = true;                                                           \
+    }                                                                          \
+    DYNXX_CHECK(thrown && #expr " throws " #E);                                \
+  } while (false)
+
+namespace DynXX::Test {
+
+    /**
+     * @brief Poll `cond` until it holds
+     * @return `false` if timed out, generous enough for sanitizer builds
+     */
+    template<typename F>
+    bool waitUntil(F &&cond, const std::chrono::milliseconds timeout = std::chrono::seconds(30))
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!cond())
+        {
+            if (std::chrono::steady_clock::now() > deadline) [[unlikely]]
+            {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    template<typename F>
+    void run(const char *name, F &&f)
+    {
+        f();
+        std::printf("%s: ok\n", name);
+    }
+}
+
+#endif // DYNXX_TEST_TESTUTIL_HXX_
@@ -0,0 +1,88 @@
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "core/concurrent/ThreadUtil.hxx"
+
+#include "TestUtil.hxx"
+
+#if defined(__linux__)
+#include <fstream>
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace DynXX::Core::Concurrent;
+
+namespace
+{
+    /// Run on a new thread, to leave the name & affinity of the main thread untouched
+    template<typename F>
+    void onNewThread(F &&f)
+    {
+        std::thread t(std::forward<F>(f));
+        t.join();
+    }
+
+    void testThreadName()
+    {
+        onNewThread([] {
+            setCurrentThreadName("DynXX-T0");
+            setCurrentThreadName("DynXX-Too-Long-Thread-Name");
+#if defined(__linux__)
+            char name[16]{};
+            DYNXX_CHECK(pthread_getname_np(pthread_self(), name, sizeof(name)) == 0);
+            DYNXX_CHECK(std::string(name) == "DynXX-Too-Long-");
+#endif
+        });
+    }
+
+    void testPinToCore()
+    {
+        onNewThread([] {
+#if defined(__linux__)
+            cpu_set_t allowed;
+            DYNXX_CHECK(sched_getaffinity(0, sizeof(allowed), &allowed) == 0);
+            auto core = 0uz;
+            while (!CPU_ISSET(core, &allowed))
+            {
+                core++;
+            }
+            DYNXX_CHECK(pinCurrentThreadToCore(core));
+
+            cpu_set_t pinned;
+            DYNXX_CHECK(sched_getaffinity(0, sizeof(pinned), &pinned) == 0);
+            DYNXX_CHECK(CPU_COUNT(&pinned) == 1 && CPU_ISSET(core, &pinned));
+            DYNXX_CHECK(sched_getcpu() == static_cast<int>(core));
+#endif
+            DYNXX_CHECK(!pinCurrentThreadToCore(static_cast<size_t>(-1)));
+        });
+    }
+
+    void testPinToNumaNode()
+    {
+        DYNXX_CHECK(countNumaNode() >= 1);
+        onNewThread([] {
+            DYNXX_CHECK(!pinCurrentThreadToNumaNode(countNumaNode()));
+#if defined(__linux__)
+            // Needs NUMA info in sysfs, missing in some containers
+            if (!std::ifstream("/sys/devices/system/node/node0/cpulist").is_open())
+            {
+                return;
+            }
+            DYNXX_CHECK(pinCurrentThreadToNumaNode(0));
+            cpu_set_t pinned;
+            DYNXX_CHECK(sched_getaffinity(0, sizeof(pinned), &pinned) == 0);
+            DYNXX_CHECK(CPU_ISSET(sched_getcpu(), &pinned));
+#endif
+        });
+    }
+}
+
+int main()
+{
+    DynXX::Test::run("thread name", testThreadName);
+    DynXX::Test::run("pin to core", testPinToCore);
+    DynXX::Test::run("pin to NUMA node", testPinToNumaNode);
+    return EXIT_SUCCESS;
+}
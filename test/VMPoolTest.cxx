@@ -0,0 +1,220 @@
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "core/vm/VMPool.hxx"
+
+#include "TestUtil.hxx"
+
+using DynXX::Core::VM::VMPool;
+
+namespace
+{
+    /// Stands in for a script VM: "scripts" are ids, calls are serialized by its own lock
+    struct DummyVM {
+        std::mutex mutex;
+        std::vector<int> scripts;
+        bool inCall{false};
+    };
+
+    struct Factory {
+        std::atomic<size_t> created{0};
+        std::atomic<bool> failing{false};
+
+        VMPool<DummyVM>::CreateF createF()
+        {
+            return [this]() -> std::unique_ptr<DummyVM> {
+                if (this->failing)
+                {
+                    return nullptr;
+                }
+                this->created++;
+                return std::make_unique<DummyVM>();
+            };
+        }
+    };
+
+    size_t countVMs(VMPool<DummyVM> &pool)
+    {
+        auto count = 0uz;
+        pool.forEach([&count](DummyVM &) { count++; });
+        return count;
+    }
+
+    VMPool<DummyVM>::LoadF script(const int id)
+    {
+        return [id](DummyVM &vm) {
+            auto lock = std::scoped_lock(vm.mutex);
+            vm.scripts.emplace_back(id);
+            return true;
+        };
+    }
+
+    void testResize()
+    {
+        Factory factory;
+        VMPool<DummyVM> pool(factory.createF());
+        DYNXX_CHECK(pool.load(script(1)));
+        DYNXX_CHECK(pool.resize(4, DynXXVMRoutingX::AnyFree));
+        DYNXX_CHECK(countVMs(pool) == 4);
+        pool.forEach([](DummyVM &vm) {
+            DYNXX_CHECK(vm.scripts == std::vector<int>{1});
+        });
+
+        DYNXX_CHECK(pool.resize(2, DynXXVMRoutingX::Sticky));
+        DYNXX_CHECK(countVMs(pool) == 2);
+
+        // The pool is left unchanged if a VM can not be created
+        factory.failing = true;
+        DYNXX_CHECK(!pool.resize(6, DynXXVMRoutingX::AnyFree));
+        DYNXX_CHECK(countVMs(pool) == 2);
+        factory.failing = false;
+
+        // A failed load is not replayed on new VMs
+        DYNXX_CHECK(!pool.load([](DummyVM &) { return false; }));
+        DYNXX_CHECK(pool.resize(3, DynXXVMRoutingX::AnyFree));
+        DYNXX_CHECK(countVMs(pool) == 3);
+        pool.forEach([](DummyVM &vm) {
+            DYNXX_CHECK(vm.scripts == std::vector<int>{1});
+        });
+
+        // The pool is left unchanged if a new VM fails to load a script
+        std::atomic<bool> brokenLater{false};
+        DYNXX_CHECK(pool.load([&brokenLater](DummyVM &) { return !brokenLater; }));
+        brokenLater = true;
+        DYNXX_CHECK(!pool.resize(5, DynXXVMRoutingX::AnyFree));
+        DYNXX_CHECK(countVMs(pool) == 3);
+    }
+
+    /// Resizing holds new checkouts back, so steady calls can not starve it
+    void testResizeUnderSteadyCalls()
+    {
+        Factory factory;
+        VMPool<DummyVM> pool(factory.createF());
+        DYNXX_CHECK(pool.resize(2, DynXXVMRoutingX::AnyFree));
+
+        std::atomic<bool> stop{false};
+        std::vector<std::thread> callers;
+        for (auto i = 0; i < 4; i++)
+        {
+            callers.emplace_back([&pool, &stop] {
+                while (!stop)
+                {
+                    pool.with([](DummyVM &) {
+                        std::this_thread::sleep_for(std::chrono::microseconds(500));
+                        return true;
+                    });
+                }
+            });
+        }
+        std::atomic<bool> resized{false};
+        std::thread resizer([&pool, &resized] {
+            for (auto size = 1uz; size <= 10; size++)
+            {
+                DYNXX_CHECK(pool.resize(size % 3 + 1, DynXXVMRoutingX::AnyFree));
+            }
+            resized = true;
+        });
+        DYNXX_CHECK(DynXX::Test::waitUntil([&resized] { return resized.load(); }, std::chrono::seconds(10)));
+        stop = true;
+        resizer.join();
+        for (auto &t : callers)
+        {
+            t.join();
+        }
+    }
+
+    /// Calls keep running while the pool is resized & loaded
+    void testResizeUnderLoad()
+    {
+        constexpr auto callerCount = 4uz;
+        constexpr auto callsPerCaller = 5'000uz;
+        Factory factory;
+        VMPool<DummyVM> pool(factory.createF());
+        DYNXX_CHECK(pool.load(script(0)));
+
+        std::atomic<bool> stop{false};
+        std::vector<std::thread> callers;
+        for (auto i = 0uz; i < callerCount; i++)
+        {
+            callers.emplace_back([&pool] {
+                for (auto j = 0uz; j < callsPerCaller; j++)
+                {
+                    const auto ok = pool.with([](DummyVM &vm) {
+                        auto lock = std::scoped_lock(vm.mutex);
+                        DYNXX_CHECK(!vm.inCall);
+                        vm.inCall = true;
+                        // Scripts are loaded in order, all VMs have at least the first one
+                        auto ordered = !vm.scripts.empty() && vm.scripts.front() == 0;
+                        for (auto k = 1uz; k < vm.scripts.size(); k++)
+                        {
+                            ordered = ordered && vm.scripts[k] == vm.scripts[k - 1] + 1;
+                        }
+                        vm.inCall = false;
+                        return ordered;
+                    });
+                    DYNXX_CHECK(ok);
+                }
+            });
+        }
+        std::thread loader([&pool, &stop] {
+            for (auto id = 1; !stop; id++)
+            {
+                DYNXX_CHECK(pool.load(script(id)));
+                std::this_thread::yield();
+            }
+        });
+        for (auto size = 1uz; size <= 32; size++)
+        {
+            DYNXX_CHECK(pool.resize(size % 6 + 1, size % 2 == 0 ? DynXXVMRoutingX::AnyFree : DynXXVMRoutingX::Sticky));
+        }
+        for (auto &t : callers)
+        {
+            t.join();
+        }
+        stop = true;
+        loader.join();
+
+        // Every VM ends up with the same scripts
+        std::vector<int> scripts;
+        pool.forEach([&scripts](DummyVM &vm) {
+            auto lock = std::scoped_lock(vm.mutex);
+            if (scripts.empty())
+            {
+                scripts = vm.scripts;
+            }
+            DYNXX_CHECK(vm.scripts == scripts);
+        });
+    }
+
+    /// VMs are checked in even if a call throws, so resizing does not wait forever
+    void testThrowingCalls()
+    {
+        Factory factory;
+        VMPool<DummyVM> pool(factory.createF());
+        DYNXX_CHECK(pool.resize(3, DynXXVMRoutingX::AnyFree));
+        DYNXX_CHECK_THROWS(pool.with([](DummyVM &) -> int { throw std::runtime_error("call"); }), std::runtime_error);
+        auto i = 0;
+        DYNXX_CHECK_THROWS(pool.forEach([&i](DummyVM &) {
+            if (++i == 2)
+            {
+                throw std::runtime_error("forEach");
+            }
+        }), std::runtime_error);
+        DYNXX_CHECK(pool.resize(1, DynXXVMRoutingX::AnyFree));
+        DYNXX_CHECK(countVMs(pool) == 1);
+    }
+}
+
+int main()
+{
+    DynXX::Test::run("resize", testResize);
+    DynXX::Test::run("resize under load", testResizeUnderLoad);
+    DynXX::Test::run("resize under steady calls", testResizeUnderSteadyCalls);
+    DynXX::Test::run("throwing calls", testThrowingCalls);
+    return EXIT_SUCCESS;
+}